@@ -3,8 +3,19 @@
 
 #include "Hypergraph.h"
 #include "Definitions.h"
+#include "NumaPlacement.h"
+#include "EElem.h"
+#include "SElem.h"
+#include "Telemetry.h"
+#include "SitePartitioning.h"
+#include "MergeHierarchy.h"
+#include "MinimalDistances.h"
+#include "PartitionState.h"
 
+#include <chrono>
 #include <cstdlib>
+#include <functional>
+#include <map>
 #include <vector>
 #include <string>
 #include <set>
@@ -18,8 +29,77 @@
 #define DEBUG_LOG(level, message)
 #endif
 
+/**
+ * How partition finds the blocks.
+ * EXACT: the rounds of the algorithm on the hypergraph itself.
+ * MULTILEVEL: the rounds on a coarsened hypergraph, then a refinement on the hypergraph itself, see Multilevel.h.
+ */
+enum class Engine {
+    EXACT,
+    MULTILEVEL
+};
+
+/**
+ * Parses the value of the --engine option.
+ *
+ * @return False if the name is unknown.
+ */
+bool parseEngine(const std::string &name, Engine &engine);
+
+/**
+ * Runtime options of the algorithm, set from the command line.
+ */
+struct PartitionOptions {
+    // Upper limit in bytes for the set S and the minimal distances while the pair loop of generateS builds them, 0 means
+    // no limit. The merged S that findMinimalSubset covers E with is not limited.
+    size_t memoryBudget = 0;
+    // Directory for the temporary files generateS spills S into when it exceeds the memory budget
+    std::string spillDirectory = "/tmp";
+    // Number of threads all parallel phases share, 0 means one per core
+    size_t numThreads = 0;
+    // Placement of E on the NUMA nodes for the pair loop of generateS
+    NumaMode numaMode = NumaMode::OFF;
+    // Cores the threads are pinned to, by their slot in the arena, empty to pin only with a NUMA mode
+    std::vector<size_t> cpus;
+    // Reorder E into locality order before each round, see reorderForLocality. Changes the indices into E and so may
+    // break ties differently, the cache and the checkpoints keep the rounds of both settings apart.
+    bool localityReordering = false;
+    // File for the per round telemetry as JSON lines, empty for none
+    std::string telemetryPath;
+    // File the state and the remaining ks are written to after a round, empty for none
+    std::string checkpointPath;
+    // Minimum number of seconds between two checkpoints, 0 means after every round
+    size_t checkpointInterval = 60;
+    // Wall clock seconds for partition, 0 for no limit. Near the limit the rounds turn approximate, the ks they do
+    // not reach in time come from a fallback merge.
+    double timeBudget = 0;
+    // When the time budget starts, e.g. at the start of the program so that parsing counts too. The default means at
+    // the start of partition.
+    std::chrono::steady_clock::time_point timeBudgetStart;
+    Engine engine = Engine::EXACT;
+    // The multilevel engine coarsens until at most this many sites differ in their hyperedges
+    size_t coarseningTarget = 1000;
+    // Refine the partitionings of the exact engine with a PartitionRefiner, the multilevel engine always does
+    bool refinement = false;
+    // Seconds the refinement may take per partitioning, 0 for no limit
+    double refinementTime = 0;
+};
+
+// Receives the partitionings partition finds, one call at a time but possibly from a worker thread
+typedef std::function<void(const SitePartitioning &partitioning)> PartitioningConsumer;
+
 Hypergraph getHypergraphFromPartitionFile(const std::string &filepath, uint32_t partitionNumber);
-void partition(const Hypergraph &hypergraph, const std::set<size_t> &setOfKs);
-void printDDF(size_t k, const std::vector<std::vector<size_t>> &partitions);
+std::map<uint32_t, Hypergraph> getHypergraphsFromPartitionFile(const std::string &filepath, const std::set<uint32_t> &partitionNumbers);
+void partition(const Hypergraph &hypergraph, const std::set<size_t> &setOfKs, const PartitionOptions &options, const PartitioningConsumer &consumer, PartitionState *state = nullptr);
+
+// The phases of a round and their helpers, see their definitions. Exposed for the pipeline benchmarks and the multilevel
+// engine, partition runs them itself.
+std::vector<EElem> generateE(const Hypergraph &hypergraph);
+std::vector<uint32_t> getLocalityOrder(const std::vector<EElem> &e);
+std::vector<SElem> generateS(size_t cmPlusD, const std::vector<EElem> &e, const PartitionOptions &options, MinimalDistances &minimalDistances,
+                             RoundStatistics &statistics, std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
+std::vector<SElem> generateSApproximate(size_t cmPlusD, const std::vector<EElem> &e, MinimalDistances &minimalDistances, RoundStatistics &statistics);
+std::vector<EElem> findMinimalSubset(const std::vector<EElem> &e, std::vector<SElem> &&s, const MinimalDistances &minimalDistances,
+                                     RoundStatistics &statistics, std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
 
 #endif //JUDICIOUSCPPOPTIMIZED_ALGORITHMS_H
@@ -3,8 +3,11 @@
 
 #include <cstdlib>
 #include <memory>
+#include <iostream>
 #include <boost/functional/hash.hpp>
 
+#include "MemoryAccounting.h"
+
 #ifdef __AVX512F__
 #define ALIGNMENT 64
 #elif __AVX2__
@@ -17,6 +20,9 @@ class AlignedBitArray {
 private:
     struct Deleter {
         void operator()(uint64_t *data) const {
+            if (data != nullptr) {
+                MemoryAccounting::countDeallocation(data);
+            }
             free(data);
         };
     };
@@ -36,6 +42,12 @@ public:
     AlignedBitArray() = default;
 
     explicit AlignedBitArray(size_t numBits);
+
+    /**
+     * Reads an array in the binary format of writeTo. Sets the failbit of the stream if it ends early.
+     */
+    explicit AlignedBitArray(std::istream &stream);
+
     AlignedBitArray(const AlignedBitArray &other);
     AlignedBitArray(AlignedBitArray &&other) noexcept;
 
@@ -57,6 +69,11 @@ public:
     size_t getNumBits() const;
     size_t getNumInts() const;
 
+    /**
+     * @return The number of bytes this array occupies, including its heap buffer.
+     */
+    size_t getMemoryUsage() const;
+
     /**
      * Gets the bit at index i. 0 is the LSB, numBits-1 is the MSB.
      *
@@ -76,17 +93,43 @@ public:
     size_t countOnes() const;
     bool covers(const AlignedBitArray &rhs) const;
     size_t calculateDistance(const AlignedBitArray &rhs) const;
+
+    /**
+     * The distance of two arrays of numInts words each that are stored outside of an AlignedBitArray.
+     */
+    static size_t calculateDistance(const uint64_t *lhs, const uint64_t *rhs, size_t numInts);
     void setRightmost(const AlignedBitArray &rhs);
+
+    /**
+     * Calculates a 64 bit hash over the whole aligned buffer. The words are mixed in independent lanes so the loop
+     * can be vectorized. This is not cached, store the result if it is needed more than once. The values differ from the
+     * former word by word boost::hash_combine, and so does the iteration order of hashed containers of combinations.
+     * No output depends on that order: generateS hands out S sorted by combination, and with DETERMINISM
+     * findMinimalSubset sorts it again by size and combination.
+     *
+     * @return The hash value.
+     */
+    uint64_t hash() const;
+
+    /**
+     * Compares by the rank in the binary reflected gray code, most significant word first. Neighbours in this order
+     * tend to differ in few bits, unlike in the plain numerical order of operator<.
+     *
+     * @param rhs The array to compare with.
+     * @return True if this array comes before rhs in gray code order.
+     */
+    bool grayCodeLess(const AlignedBitArray &rhs) const;
+
+    /**
+     * Writes the array in a compact binary format: the number of bits followed by the raw words.
+     */
+    void writeTo(std::ostream &stream) const;
 };
 
 namespace std {
     template <> struct hash<AlignedBitArray> {
         size_t operator()(const AlignedBitArray &array) const {
-            size_t result = 0;
-            for (size_t i = 0; i < array.getNumInts(); i++) {
-                boost::hash_combine(result, std::hash<uint64_t>{}(array[i]));
-            }
-            return result;
+            return array.hash();
         }
     };
 }
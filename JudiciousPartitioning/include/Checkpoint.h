@@ -0,0 +1,31 @@
+#ifndef JUDICIOUSPARTITIONING_CHECKPOINT_H
+#define JUDICIOUSPARTITIONING_CHECKPOINT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "PartitionState.h"
+
+/*
+ * A checkpoint lets a killed partition run continue from its last completed round. The file holds a magic number,
+ * the key of the hypergraph (see ResultCache::getKey), the number of remaining ks and the ks in ascending order, all
+ * as little endian 64 bit integers on any host, followed by the state in the format of PartitionState::writeTo.
+ */
+
+/**
+ * Writes a checkpoint to a temporary file and renames it to path, so a run killed while writing keeps the previous
+ * checkpoint.
+ *
+ * @return False if it could not be written.
+ */
+bool writeCheckpoint(const std::string &path, uint64_t key, const std::vector<size_t> &remainingKs, const PartitionState &state);
+
+/**
+ * Reads a checkpoint written by writeCheckpoint.
+ *
+ * @return False if the file is missing, ends early, holds a length that does not fit in it or holds no checkpoint.
+ */
+bool readCheckpoint(const std::string &path, uint64_t &key, std::vector<size_t> &remainingKs, PartitionState &state);
+
+#endif //JUDICIOUSPARTITIONING_CHECKPOINT_H
@@ -0,0 +1,91 @@
+#ifndef JUDICIOUSPARTITIONING_DDFWRITER_H
+#define JUDICIOUSPARTITIONING_DDFWRITER_H
+
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Writes partitions in the DDF output format. Each DDF is formatted into one buffer and written with a single call,
+ * without flushing per line. It goes to standard output, to a file <k>.ddf per k in a directory, or into one
+ * container file. The container holds the DDFs one after the other, then an index entry per DDF with its k, offset
+ * and length, then the number of entries and a magic number, all as little endian 64 bit integers on any host.
+ * write can be called from several threads, the order of the DDFs in standard output and in the container is the
+ * order of the calls.
+ */
+class DDFWriter {
+public:
+    enum class Target {
+        STDOUT,
+        DIRECTORY,
+        CONTAINER
+    };
+
+    struct IndexEntry {
+        uint64_t k;
+        uint64_t offset;
+        uint64_t length;
+    };
+
+private:
+    Target target;
+    std::string path;
+    std::ofstream container;
+    std::vector<IndexEntry> index;
+    uint64_t offset = 0;
+    std::mutex mutex;
+    bool failed = false;
+
+public:
+    // ##### Constructors
+    /**
+     * Creates the directory if it does not exist. Throws a std::runtime_error if the directory or the container file
+     * cannot be created.
+     *
+     * @param path The directory or the container file, ignored for STDOUT.
+     */
+    explicit DDFWriter(Target target = Target::STDOUT, const std::string &path = "");
+
+    /**
+     * Calls finish.
+     */
+    ~DDFWriter();
+
+    DDFWriter(const DDFWriter &other) = delete;
+    DDFWriter &operator=(const DDFWriter &other) = delete;
+
+    // ##### Functions
+    /**
+     * Appends the DDF of a partitioning to a buffer.
+     *
+     * @param buffer The buffer to append to.
+     * @param k The number of partitions.
+     * @param partitions The sites of each partition.
+     */
+    static void format(std::string &buffer, size_t k, const std::vector<std::vector<size_t>> &partitions);
+
+    /**
+     * Formats and writes the DDF of a partitioning.
+     *
+     * @return False if it could not be written.
+     */
+    bool write(size_t k, const std::vector<std::vector<size_t>> &partitions);
+
+    /**
+     * Writes the index of the container and reads it back to check it. Further calls do nothing.
+     *
+     * @return False if any DDF or the index could not be written.
+     */
+    bool finish();
+
+    /**
+     * Reads the index of a container, the DDF of an entry is the length bytes from its offset. Throws a
+     * std::runtime_error if the file cannot be read or does not end in a valid index.
+     */
+    static std::vector<IndexEntry> readIndex(const std::string &path);
+};
+
+#endif //JUDICIOUSPARTITIONING_DDFWRITER_H
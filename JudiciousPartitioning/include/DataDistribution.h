@@ -0,0 +1,44 @@
+#ifndef JUDICIOUSPARTITIONING_DATADISTRIBUTION_H
+#define JUDICIOUSPARTITIONING_DATADISTRIBUTION_H
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * The sites of each partition that each CPU gets, as in a DDF. JudiciousPartitioning writes one partition per CPU,
+ * the hybrid distribution of partitionSplits can give a CPU the sites of several partitions.
+ */
+struct DataDistribution {
+    struct Assignment {
+        uint32_t partition;
+        std::vector<uint32_t> sites;
+    };
+
+    // The name and the assignments of each CPU, in the order of the DDF
+    std::vector<std::string> cpus;
+    std::vector<std::vector<Assignment>> blocks;
+
+    // ##### Constructors
+    DataDistribution() = default;
+
+    /**
+     * Reads a DDF: the number of CPUs, then for each CPU a line with its name and number of assignments, followed by
+     * a line per assignment with the partition name (partition_<number>), the number of sites and the sites. Sets the
+     * failbit of the stream if it ends early or is malformed.
+     */
+    explicit DataDistribution(std::istream &stream);
+
+    // ##### Getters/Setters
+    size_t getK() const;
+
+    // ##### Functions
+    /**
+     * Writes the distribution as a DDF, in the format the constructor reads.
+     */
+    void writeTo(std::ostream &stream) const;
+};
+
+#endif //JUDICIOUSPARTITIONING_DATADISTRIBUTION_H
@@ -12,4 +12,10 @@
 // Used Representation
 using BitRepresentation = AlignedBitArray;
 
+// Number of 64 bit words the combinations are folded onto for the pair prefilter in generateS
+#define SIGNATURE_WORDS 8
+
+// Estimated heap bytes of one std::set<uint32_t> node including the allocator overhead, used for memory estimates
+#define SET_NODE_BYTES 48
+
 #endif //JUDICIOUSPARTITIONING_DEFINITIONS_H
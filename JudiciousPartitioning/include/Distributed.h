@@ -0,0 +1,55 @@
+#ifndef JUDICIOUSPARTITIONING_DISTRIBUTED_H
+#define JUDICIOUSPARTITIONING_DISTRIBUTED_H
+
+#include "SElem.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * Communication between the ranks of the MPI build. Every rank runs the whole algorithm on the same E and only the
+ * pair loop of generateS and the set S are split between them. Without MPI_ENABLED there is exactly one rank and all
+ * functions return their input.
+ */
+
+void initDistributed(int &argc, char **&argv);
+void finalizeDistributed();
+
+/**
+ * Ends all ranks with the exit code if there are several. A rank that stops on its own would leave the others waiting
+ * in their next collective call.
+ */
+void abortDistributed(int code);
+
+int getRank();
+int getNumRanks();
+
+/**
+ * Lowers each value to the minimum of that value over all ranks.
+ */
+void allreduceMinimum(std::vector<uint64_t> &values);
+
+/**
+ * @return The sum of the value over all ranks.
+ */
+uint64_t allreduceSum(uint64_t value);
+
+/**
+ * Moves each element of S to the rank owning its combination and merges the elements with equal combinations there,
+ * just like generateS does when inserting into its set.
+ *
+ * @param local The part of S found on this rank.
+ * @return The part of S owned by this rank, sorted by combination.
+ */
+std::vector<SElem> exchangeS(std::vector<SElem> &&local);
+
+/**
+ * Collects one element from each rank that has one.
+ *
+ * @param candidate The element of this rank or nullptr.
+ * @return The rank and a copy of the element for each rank that passed one, in rank order.
+ */
+std::vector<std::pair<int, SElem>> allgatherCandidates(const SElem *candidate);
+
+#endif //JUDICIOUSPARTITIONING_DISTRIBUTED_H
@@ -3,6 +3,7 @@
 
 #include "Definitions.h"
 #include "SElem.h"
+#include "Signature.h"
 #include "AlignedBitArray.h"
 #include "SparseBitVector.h"
 
@@ -15,6 +16,10 @@
 class EElem {
 private:
     BitRepresentation combination;
+    // Cached hash of the combination, see updateHash
+    uint64_t combinationHash{};
+    // Cached signature of the combination, see updateSignature
+    Signature signature;
     // Elements of the original e set that are covered by this combination.
     mutable std::set<uint32_t> coveredE0Elems;
 
@@ -35,7 +40,15 @@ public:
      */
     explicit EElem(SElem &&original);
 
+    /**
+     * Reads an element in the binary format of writeTo. Sets the failbit of the stream if it ends early.
+     */
+    explicit EElem(std::istream &stream);
+
     // ##### Operators
+    /**
+     * Compares the cached hashes first and the combinations only on a hash match.
+     */
     friend bool operator== (const EElem &lhs, const EElem &rhs);
     friend bool operator!= (const EElem &lhs, const EElem &rhs);
 
@@ -52,13 +65,41 @@ public:
     BitRepresentation &getCombination();
     std::set<uint32_t> &getCoveredE0Elems() const;
     std::set<uint32_t> &getCoveredE0Elems();
+    uint64_t getHash() const;
+    const Signature &getSignature() const;
     size_t countOnes() const;
+
+    /**
+     * @return The estimated number of bytes this element occupies, including its combination and covered set.
+     */
+    size_t getMemoryUsage() const;
+
+    /**
+     * @return The estimated number of bytes of the set of covered original elements alone.
+     */
+    size_t getCoveredE0MemoryUsage() const;
+
+    // ##### Functions
+    /**
+     * Recalculates the cached hash. Call this after modifying the combination in place.
+     */
+    void updateHash();
+
+    /**
+     * Recalculates the cached signature. Call this after modifying the combination in place.
+     */
+    void updateSignature();
+
+    /**
+     * Writes the element in a compact binary format: the combination followed by the covered original elements.
+     */
+    void writeTo(std::ostream &stream) const;
 };
 
 namespace std {
     template <> struct hash<EElem> {
         size_t operator()(const EElem &e) const {
-            return std::hash<BitRepresentation>{}(e.getCombination());
+            return e.getHash();
         }
     };
 }
@@ -5,12 +5,96 @@
 #include "Hypergraph.h"
 
 #include <string>
+#include <set>
+#include <vector>
+#include <cstdint>
+#include <iostream>
 
+/**
+ * Starts and stops a phase of the Profiler on the calling thread. Phases nest, so endTM has to stop the phase started
+ * last.
+ */
 void startTM(const std::string &identifier);
 void endTM(const std::string &identifier);
+
+/**
+ * Prints the time of each top level phase, the one of "Runtime" to stdout and the others to stderr.
+ */
 void printAllTM();
 bool partitionsContainAllVertices(const Hypergraph &hypergraph, const std::vector<std::vector<size_t>> &line);
 std::vector<std::string> splitLineAtSpaces(const std::string &line);
 uint32_t stringToUint32t(const std::string &theString);
 
+/**
+ * Parses a command line value that has to be a non-negative finite number, e.g. a number of seconds.
+ *
+ * @return False if the text is anything else or has trailing characters.
+ */
+bool parseNumber(const std::string &text, double &number);
+
+/**
+ * Parses a command line value that has to be a non-negative integer, e.g. a number of threads.
+ *
+ * @return False if the text is anything else, has trailing characters or is too large.
+ */
+bool parseNumber(const std::string &text, size_t &number);
+
+/**
+ * Parses a command line value that has to be a comma separated list of non-negative integers, e.g. "0,1,8,9".
+ *
+ * @return False if any of the elements is not such a number.
+ */
+bool parseNumbers(const std::string &text, std::vector<size_t> &numbers);
+
+/**
+ * Extract a set of k's from the string that is input on the command line.
+ * E.g., get {2, 4, 8} from "2,4,8"
+ */
+std::set<size_t> getKSetFromKString(std::string kString);
+
+/**
+ * Writes a number as 8 little endian bytes, whatever the byte order of the host.
+ */
+void writeUint64(std::ostream &stream, uint64_t value);
+
+/**
+ * Reads a number in the format of writeUint64.
+ *
+ * @return The number, or 0 if the stream ends early, which sets its failbit.
+ */
+uint64_t readUint64(std::istream &stream);
+
+/**
+ * Writes an array of uint32_t or uint64_t values as little endian integers of their size.
+ */
+template <typename T>
+void writeArray(std::ostream &stream, const T *values, size_t size);
+
+/**
+ * Reads an array in the format of writeArray. Sets the failbit of the stream if it ends early.
+ */
+template <typename T>
+void readArray(std::istream &stream, T *values, size_t size);
+
+/**
+ * Checks a length read from a stream before anything of that size is allocated, so a damaged file fails to read
+ * instead of allocating whatever it says. Lengths of up to 64 KiB are always accepted, as checking them would cost a
+ * seek each, and so are lengths in streams that cannot seek.
+ *
+ * @return False, and sets the failbit of the stream, if fewer bytes are left than count elements of elementSize.
+ */
+bool fitsInStream(std::istream &stream, uint64_t count, size_t elementSize);
+
+/**
+ * Writes a set of indices in a compact binary format: the number of elements followed by the elements, as little
+ * endian integers.
+ */
+void writeIndexSet(std::ostream &stream, const std::set<uint32_t> &set);
+
+/**
+ * Reads a set of indices in the format of writeIndexSet. Sets the failbit of the stream if it ends early or the
+ * number of elements does not fit in it.
+ */
+std::set<uint32_t> readIndexSet(std::istream &stream);
+
 #endif //JUDICIOUSCPPOPTIMIZED_HELPER_H
@@ -0,0 +1,81 @@
+#ifndef JUDICIOUSPARTITIONING_HUGEPAGEALLOCATOR_H
+#define JUDICIOUSPARTITIONING_HUGEPAGEALLOCATOR_H
+
+#include <cstdlib>
+#include <new>
+#include <sys/mman.h>
+
+#include "MemoryAccounting.h"
+
+// Size of a transparent huge page on x86-64
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+/**
+ * Allocator for large read-mostly slabs. Allocations of at least one huge page are mapped separately and advised to be
+ * backed by transparent huge pages, which cuts the TLB misses of scans over the whole slab. Smaller allocations use
+ * malloc. The pages of a mapping are placed by the memory policy of the thread that touches them first, unless the
+ * mapping is bound to nodes before.
+ */
+template <typename T>
+class HugePageAllocator {
+public:
+    using value_type = T;
+
+    // ##### Constructors
+    HugePageAllocator() = default;
+
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U> &) noexcept {
+    }
+
+    // ##### Operators
+    template <typename U>
+    bool operator==(const HugePageAllocator<U> &) const noexcept {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const HugePageAllocator<U> &) const noexcept {
+        return false;
+    }
+
+    // ##### Functions
+    T *allocate(size_t n) {
+        size_t bytes = n * sizeof(T);
+        if (bytes < HUGE_PAGE_SIZE) {
+            void *raw = malloc(bytes);
+            if (raw == nullptr) {
+                throw std::bad_alloc();
+            }
+            MemoryAccounting::countAllocation(raw);
+            return static_cast<T *>(raw);
+        }
+
+        void *raw = mmap(nullptr, roundUp(bytes), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        // Only a hint, the slab works with normal pages too if the kernel has THP disabled
+        madvise(raw, roundUp(bytes), MADV_HUGEPAGE);
+        MemoryAccounting::countBytes(roundUp(bytes));
+        return static_cast<T *>(raw);
+    }
+
+    void deallocate(T *pointer, size_t n) noexcept {
+        size_t bytes = n * sizeof(T);
+        if (bytes < HUGE_PAGE_SIZE) {
+            MemoryAccounting::countDeallocation(pointer);
+            free(pointer);
+        } else {
+            munmap(pointer, roundUp(bytes));
+            MemoryAccounting::countBytes(-static_cast<int64_t>(roundUp(bytes)));
+        }
+    }
+
+private:
+    static size_t roundUp(size_t bytes) {
+        return (bytes + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    }
+};
+
+#endif //JUDICIOUSPARTITIONING_HUGEPAGEALLOCATOR_H
@@ -0,0 +1,56 @@
+#ifndef JUDICIOUSPARTITIONING_HYBRIDPARTITIONING_H
+#define JUDICIOUSPARTITIONING_HYBRIDPARTITIONING_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "DataDistribution.h"
+#include "Hypergraph.h"
+#include "JudiciousPartitioner.h"
+#include "SitePartitioning.h"
+
+/**
+ * The CPUs that a partition goes to in a splits file of RDDA, and the share of the partition each of them gets.
+ */
+struct PartitionSplit {
+    uint32_t partition;
+    std::vector<std::string> cpus;
+    std::vector<double> proportions;
+};
+
+/**
+ * Reads a splits file: for each partition a line with its name (partition_<number>) and number of CPUs, followed by a
+ * line per CPU with its name and share. The share can be left out if the partition is not split. Other lines are
+ * skipped. The CPU names have to end in a number.
+ *
+ * @return False if the file is missing or malformed.
+ */
+bool readSplits(const std::string &path, std::vector<PartitionSplit> &splits);
+
+/**
+ * Scales the shares by 10, 20, 30, ... and rounds them half to even until each one is at least 2. The sum of the
+ * rounded shares is the k the partition is split into.
+ */
+std::vector<size_t> roundProportions(const std::vector<double> &proportions);
+
+/**
+ * Merges the blocks of a partitioning into one block per rounded share. In descending order of their repeat classes,
+ * each block goes to the merged block that is furthest below its share of the repeat classes of the partition. Whole
+ * blocks are merged, so all CPUs together never get more repeat classes than the blocks of the partitioning have.
+ *
+ * @return The sites of each merged block in ascending order.
+ */
+std::vector<std::vector<uint32_t>> mergeBlocks(const Hypergraph &hypergraph, const SitePartitioning &partitioning, const std::vector<size_t> &roundedProportions);
+
+/**
+ * The hybrid data distribution of a repeats file. Each split partition is partitioned for the k of its rounded shares
+ * only, and its blocks are merged to the shares. Each partition that is not split goes to its CPU as a whole. The
+ * partitions are read in one pass and partitioned at the same time, sharing the threads of the partitioner.
+ * Throws a std::runtime_error if the repeats file does not have a partition of the splits.
+ *
+ * @return The distribution with the CPUs in the order of the number their names end in, each named CPU<number>.
+ */
+DataDistribution partitionSplits(JudiciousPartitioner &partitioner, const std::string &repeatsPath, const std::vector<PartitionSplit> &splits);
+
+#endif //JUDICIOUSPARTITIONING_HYBRIDPARTITIONING_H
@@ -19,6 +19,15 @@ public:
     // ##### Constructors
     Hypergraph(std::vector<uint32_t> hypernodes, std::vector<hElem> hyperedges);
 
+    /**
+     * Creates the hypergraph of a partition from its repeat classes. Each site is a hypernode and each repeat class
+     * of a row a hyperedge, in the order of the rows and of the class identifiers. The identifiers of a row have to
+     * be 0, 1, 2, ... without gaps, classes after a gap are ignored.
+     *
+     * @param rows One row per internal node of the tree, holding the repeat class identifier of each site.
+     */
+    static Hypergraph fromRepeatClasses(const std::vector<std::vector<uint32_t>> &rows);
+
     // ##### Getters/Setters
     const std::vector<uint32_t> &getHypernodes() const;
     const std::vector<hElem> &getHyperEdges() const;
@@ -0,0 +1,83 @@
+#ifndef JUDICIOUSPARTITIONING_JUDICIOUSPARTITIONER_H
+#define JUDICIOUSPARTITIONING_JUDICIOUSPARTITIONER_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <set>
+#include <vector>
+#include <tbb/task_arena.h>
+
+#include "Algorithms.h"
+#include "Hypergraph.h"
+#include "MergeHierarchy.h"
+#include "Multilevel.h"
+#include "NumaPlacement.h"
+#include "PartitionRefiner.h"
+#include "PartitionState.h"
+#include "PerfCounters.h"
+#include "SitePartitioning.h"
+
+/**
+ * The entry point for programs that embed the algorithm instead of calling the command line program. It keeps one
+ * task arena for all its calls, so the worker threads are only started once. Several partition calls can run at the
+ * same time, e.g. from a parallel loop in execute, as long as they do not write the same checkpoint or telemetry file.
+ */
+class JudiciousPartitioner {
+private:
+    PartitionOptions options;
+    tbb::task_arena arena;
+    std::unique_ptr<ThreadPinning> pinning;
+    std::unique_ptr<PerfCounters::ThreadObserver> counters;
+
+public:
+    // ##### Constructors
+    /**
+     * Sets up the threads for options.numThreads and options.numaMode. Enable PerfCounters before this if the
+     * phases should be counted.
+     */
+    explicit JudiciousPartitioner(const PartitionOptions &options = PartitionOptions());
+
+    JudiciousPartitioner(const JudiciousPartitioner &other) = delete;
+    JudiciousPartitioner &operator=(const JudiciousPartitioner &other) = delete;
+
+    // ##### Functions
+    /**
+     * Runs a function in the arena. The partition calls of its parallel loops share the threads of the arena with
+     * each other instead of starting more.
+     */
+    void execute(const std::function<void()> &function);
+
+    /**
+     * Partitions the sites of a hypergraph for each k and hands each partitioning to the consumer as soon as it is
+     * found, largest k first. The consumer runs while the next round is computed, possibly on a worker thread.
+     *
+     * @param state If not null, the rounds continue from it and it gets the state after the last round, e.g. to
+     *              store it in a ResultCache. Only for the exact engine, the multilevel engine ignores it.
+     *
+     * Throws a std::invalid_argument for the multilevel engine with a checkpoint path, see partitionMultilevel.
+     */
+    void partition(const Hypergraph &hypergraph, const std::set<size_t> &ks, const PartitioningConsumer &consumer, PartitionState *state = nullptr);
+
+    /**
+     * @return The partitionings of the sites of a hypergraph for each k, in ascending order of k.
+     */
+    std::vector<SitePartitioning> partition(const Hypergraph &hypergraph, const std::set<size_t> &ks);
+
+    /**
+     * @param rows The repeat classes of a partition, see Hypergraph::fromRepeatClasses.
+     * @return The partitionings of its sites for each k, in ascending order of k.
+     */
+    std::vector<SitePartitioning> partition(const std::vector<std::vector<uint32_t>> &rows, const std::set<size_t> &ks);
+
+    /**
+     * Runs the rounds down to minimumK and records them instead of handing out partitionings. The partitioning for
+     * any k of at least minimumK can then be extracted from the result. Always uses the exact engine.
+     *
+     * @param state If not null, the rounds continue from it like for partition and it gets the state after the last
+     *              round.
+     */
+    MergeHierarchy partitionHierarchy(const Hypergraph &hypergraph, size_t minimumK, PartitionState *state = nullptr);
+};
+
+#endif //JUDICIOUSPARTITIONING_JUDICIOUSPARTITIONER_H
@@ -0,0 +1,54 @@
+#ifndef JUDICIOUSPARTITIONING_MEMORYACCOUNTING_H
+#define JUDICIOUSPARTITIONING_MEMORYACCOUNTING_H
+
+#include <cstdint>
+
+/**
+ * Counts the live heap bytes and the number of allocations of the process. Memory from malloc or mmap is counted by
+ * the code that allocates it (AlignedBitArray, HugePageAllocator). JudiciousPartitioning, which reports the counts, also
+ * links src/AllocationCounting.cpp, whose global operator new and delete count themselves. A program that embeds the
+ * library without it keeps its own allocation functions and only sees the explicitly counted memory. Threads collect their
+ * counts locally and add them to the shared counters in batches, so the counts can lag behind by a few hundred
+ * kilobytes per thread.
+ */
+class MemoryAccounting {
+public:
+    // ##### Getters/Setters
+    static int64_t getLiveBytes();
+    static uint64_t getNumAllocations();
+
+    // ##### Functions
+    /**
+     * Counts a block from malloc, posix_memalign or operator new with its usable size.
+     */
+    static void countAllocation(void *pointer);
+
+    /**
+     * Counts the release of a block counted by countAllocation, call it before freeing the block.
+     */
+    static void countDeallocation(void *pointer);
+
+    /**
+     * Counts memory that is not from malloc, e.g. an mmap, with a negative size for the release.
+     */
+    static void countBytes(int64_t bytes);
+
+    /**
+     * Starts measuring the high-water mark of the live bytes for a phase. Each phase has its own mark, so phases on
+     * different threads neither have to nest nor reset each other. The live bytes belong to the whole process, so the
+     * mark includes what other tasks allocate at the same time, e.g. the output of the previous round.
+     *
+     * @return The slot of the phase, to pass to endPeak. -1 if 64 phases are measured already.
+     */
+    static int beginPeak();
+
+    /**
+     * Ends measuring the high-water mark of a phase.
+     *
+     * @param slot The return value of the matching beginPeak.
+     * @return The high-water mark of the live bytes since beginPeak, 0 for the slot -1.
+     */
+    static int64_t endPeak(int slot);
+};
+
+#endif //JUDICIOUSPARTITIONING_MEMORYACCOUNTING_H
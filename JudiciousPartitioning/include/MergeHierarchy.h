@@ -0,0 +1,107 @@
+#ifndef JUDICIOUSPARTITIONING_MERGEHIERARCHY_H
+#define JUDICIOUSPARTITIONING_MERGEHIERARCHY_H
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "EElem.h"
+#include "SitePartitioning.h"
+
+/**
+ * The blocks of all rounds of a partition run in one structure. Each block of S* is a union of whole blocks of the
+ * previous round, as findMinimalSubset only removes the covered original elements of blocks that are completely
+ * covered already. So the rounds form a merge forest and the sites can be ordered such that every block of every
+ * round is a contiguous range of this order. A partitioning for any k the run reached is then extracted in
+ * O(sites), without running the rounds again or storing a partitioning per k.
+ */
+class MergeHierarchy {
+private:
+    // Ordered so that every block of every round is a contiguous range
+    std::vector<uint32_t> siteOrder;
+    // For each round and each block of its S*, in the order of S*: the first position in siteOrder and the number
+    // of sites
+    std::vector<std::vector<uint32_t>> blockBegins;
+    std::vector<std::vector<uint32_t>> blockSizes;
+
+public:
+    /**
+     * Records the blocks of each round while partition runs.
+     */
+    class Recorder {
+    private:
+        // levels[0] maps each site to its element of E, levels[r] each block of round r - 1 (of E for r = 1) to
+        // its block in round r
+        std::vector<std::vector<uint32_t>> levels;
+        // One site of each block of the last recorded round, in the order of its S*
+        std::vector<uint32_t> representatives;
+
+    public:
+        // ##### Constructors
+        /**
+         * Constructs a recorder without any levels, only use for variables that get assigned over!
+         */
+        Recorder() = default;
+
+        Recorder(const std::vector<EElem> &e, size_t numSites);
+
+        /**
+         * Reads a recorder in the binary format of writeTo. Sets the failbit of the stream if it ends early or a size
+         * does not fit in it.
+         */
+        explicit Recorder(std::istream &stream);
+
+        // ##### Getters/Setters
+        size_t getNumSites() const;
+        size_t getNumRounds() const;
+
+        // ##### Functions
+        void addRound(const std::vector<EElem> &sStar);
+        MergeHierarchy finish() const;
+
+        /**
+         * Writes the recorded levels and representatives in a compact binary format, each as its size followed by
+         * its elements, all as little endian integers.
+         */
+        void writeTo(std::ostream &stream) const;
+    };
+
+    // ##### Constructors
+    /**
+     * Constructs an empty hierarchy without rounds.
+     */
+    MergeHierarchy() = default;
+
+    /**
+     * Reads a hierarchy in the binary format of writeTo. Sets the failbit of the stream if it ends early, a size does
+     * not fit in it or it does not hold a hierarchy whose blocks lie within the site order.
+     */
+    explicit MergeHierarchy(std::istream &stream);
+
+    // ##### Getters/Setters
+    size_t getNumSites() const;
+    size_t getNumRounds() const;
+
+    /**
+     * @return The number of blocks of a round, i.e. its k.
+     */
+    size_t getK(size_t round) const;
+
+    // ##### Functions
+    /**
+     * Extracts the partitioning for k, from the first round with at most k blocks like partition does.
+     *
+     * @return False if no round reached k.
+     */
+    bool extract(size_t k, SitePartitioning &partitioning) const;
+
+    /**
+     * Writes the hierarchy in a compact binary format: a magic number, the number of sites and the site order,
+     * then the number of rounds and for each round its k followed by the begins and sizes of its blocks. Sizes and k
+     * are little endian 64 bit integers, everything else little endian 32 bit integers.
+     */
+    void writeTo(std::ostream &stream) const;
+};
+
+#endif //JUDICIOUSPARTITIONING_MERGEHIERARCHY_H
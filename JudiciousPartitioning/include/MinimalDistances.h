@@ -0,0 +1,59 @@
+#ifndef JUDICIOUSPARTITIONING_MINIMALDISTANCES_H
+#define JUDICIOUSPARTITIONING_MINIMALDISTANCES_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * The minimal distance of each element of the set E of a round to any other element of E, and the index of that
+ * other element. generateS and generateSApproximate compute them, the fill-up of findMinimalSubset flips the bits
+ * towards the other element. Each round has its own instance, so several rounds can run at the same time.
+ *
+ * Each entry packs the distance into the upper 32 bits and the index into the lower 32 bits. Packing both into one
+ * word lets the pair loop update an entry with a single atomic minimum and without allocating. On equal distances the
+ * smaller index wins. The pair loop only skips pairs that cannot lower the packed entry, so the result is the element
+ * with the smallest index among the closest ones, no matter in which order the threads find them.
+ */
+class MinimalDistances {
+private:
+    std::unique_ptr<std::atomic<uint64_t>[]> entries;
+    size_t numElements = 0;
+
+public:
+    // ##### Constructors
+    MinimalDistances() = default;
+
+    // ##### Getters/Setters
+    size_t size() const;
+    size_t getMemoryUsage() const;
+    size_t getDistance(size_t eidx) const;
+    uint32_t getIndex(size_t eidx) const;
+
+    // ##### Functions
+    /**
+     * Sets all entries of a set E of numElements elements to an infinite distance.
+     */
+    void reset(size_t numElements);
+
+    /**
+     * Lowers the entry of eidx to the distance to the element otherEidx if that is smaller, or equally small with a
+     * smaller index. Safe to call from several threads at once.
+     */
+    void lower(size_t eidx, size_t distance, uint32_t otherEidx);
+
+    /**
+     * @return Whether a pair of eidx and otherEidx with a distance of at least lowerBound can no longer lower the
+     * entry of eidx.
+     */
+    bool cannotLower(size_t eidx, size_t lowerBound, uint32_t otherEidx) const;
+
+    /**
+     * Copies the packed entries out and back in, for combining the entries of all ranks.
+     */
+    std::vector<uint64_t> getEntries() const;
+    void setEntries(const std::vector<uint64_t> &newEntries);
+};
+
+#endif //JUDICIOUSPARTITIONING_MINIMALDISTANCES_H
@@ -0,0 +1,30 @@
+#ifndef JUDICIOUSPARTITIONING_MULTILEVEL_H
+#define JUDICIOUSPARTITIONING_MULTILEVEL_H
+
+#include <set>
+
+#include "Algorithms.h"
+#include "Hypergraph.h"
+
+/**
+ * Coarsens a hypergraph in levels until at most targetSites sites differ in their hyperedges. Each level matches every
+ * distinct site with the closest unmatched one of the next few in locality order and merges the repeat classes in
+ * which the two differ, row by row. A site keeps one class per row, so the hypergraph keeps its uniform degree and
+ * matched sites end up with the same hyperedges. The sites stay the same, only the hyperedges get fewer and larger.
+ *
+ * @return The coarse hypergraph, with the merged hyperedges in the order of their first original hyperedge.
+ */
+Hypergraph coarsenHypergraph(const Hypergraph &hypergraph, size_t targetSites);
+
+/**
+ * The multilevel engine: runs partition on the hypergraph coarsened to options.coarseningTarget distinct sites, but not
+ * below the largest k, and refines each partitioning with a
+ * PartitionRefiner on the original one. As the sites are the same, the partitionings need no projection. They are
+ * marked as not exact. Must be called inside a task arena like partition.
+ *
+ * Throws a std::invalid_argument if options.checkpointPath is set, as the rounds run on a different hypergraph than
+ * the one a checkpoint would be resumed for.
+ */
+void partitionMultilevel(const Hypergraph &hypergraph, const std::set<size_t> &setOfKs, const PartitionOptions &options, const PartitioningConsumer &consumer);
+
+#endif //JUDICIOUSPARTITIONING_MULTILEVEL_H
@@ -0,0 +1,127 @@
+#ifndef JUDICIOUSPARTITIONING_NUMAPLACEMENT_H
+#define JUDICIOUSPARTITIONING_NUMAPLACEMENT_H
+
+#include "Definitions.h"
+#include "EElem.h"
+#include "Signature.h"
+#include "HugePageAllocator.h"
+
+#include <string>
+#include <vector>
+#include <tbb/task_arena.h>
+#include <tbb/task_scheduler_observer.h>
+
+/**
+ * How the data of E that generateS scans is placed on a machine with several NUMA nodes.
+ * OFF: one copy, placed wherever it was allocated, threads are not pinned.
+ * REPLICATE: one copy per node, threads are pinned and read the copy of their node.
+ * INTERLEAVE: one copy with its pages spread over all nodes, threads are pinned.
+ */
+enum class NumaMode {
+    OFF,
+    REPLICATE,
+    INTERLEAVE
+};
+
+/**
+ * Parses the value of the --numa option.
+ *
+ * @return False if the name is unknown or NUMA support was not compiled in.
+ */
+bool parseNumaMode(const std::string &name, NumaMode &mode);
+
+/**
+ * Pins each thread to the core of its slot in the arena while it works there, and gives it back its previous affinity
+ * when it leaves. The slots are unique within the arena, so no two threads of it share a core. Unless the cores are
+ * given, they are handed out one NUMA node after the other, so a run with fewer threads than cores stays on as few
+ * nodes as possible.
+ */
+class ThreadPinning : public tbb::task_scheduler_observer {
+private:
+    std::vector<int> cpus;
+    std::vector<int> nodes;
+
+public:
+    // ##### Constructors
+    /**
+     * Starts observing the arena right away.
+     *
+     * @param cpus The core of each slot, empty for all cores node by node.
+     */
+    ThreadPinning(tbb::task_arena &arena, const std::vector<size_t> &cpus);
+    ~ThreadPinning() override;
+
+    // ##### Functions
+    void on_scheduler_entry(bool isWorker) override;
+    void on_scheduler_exit(bool isWorker) override;
+
+    /**
+     * @return The node the calling thread was pinned to, 0 if it was not pinned.
+     */
+    static int getCurrentNode();
+};
+
+/**
+ * Copies of the combinations and signatures of E for the pair loop of generateS, built once per E by the threads of
+ * the calling arena. Each copy keeps the words of all combinations back to back in one slab and the signatures in
+ * another, both backed by huge pages. With NumaMode::REPLICATE the pages of each copy are bound to one node, with
+ * NumaMode::INTERLEAVE the pages of the single copy are spread over all nodes. The memory policy of the threads is
+ * left alone. With NumaMode::OFF nothing is copied and the views read E itself.
+ */
+class EReplicas {
+private:
+    struct Replica {
+        std::vector<uint64_t, HugePageAllocator<uint64_t>> words;
+        std::vector<Signature, HugePageAllocator<Signature>> signatures;
+    };
+
+    const std::vector<EElem> &e;
+    // Words per combination, the same for all elements of E
+    size_t numInts = 0;
+    std::vector<Replica> replicas;
+
+    /**
+     * Allocates the slabs of the replica, lets place bind their pages before anything touches them and copies E in
+     * parallel.
+     */
+    template <typename Place>
+    void fill(Replica &replica, const Place &place);
+
+public:
+    /**
+     * Read access to one copy, or to E itself if there is none.
+     */
+    class View {
+    private:
+        const EElem *e;
+        const Replica *replica;
+        size_t numInts;
+
+    public:
+        View(const EElem *e, const Replica *replica, size_t numInts) : e(e), replica(replica), numInts(numInts) {
+        }
+
+        size_t calculateDistance(size_t firstEidx, size_t secondEidx) const {
+            if (replica) {
+                const uint64_t *words = replica->words.data();
+                return AlignedBitArray::calculateDistance(words + firstEidx * numInts, words + secondEidx * numInts, numInts);
+            }
+            return e[firstEidx].getCombination().calculateDistance(e[secondEidx].getCombination());
+        }
+
+        const Signature &getSignature(size_t eidx) const {
+            return replica ? replica->signatures[eidx] : e[eidx].getSignature();
+        }
+    };
+
+    // ##### Constructors
+    EReplicas(const std::vector<EElem> &e, NumaMode mode);
+
+    // ##### Getters/Setters
+    /**
+     * @return The view for the calling thread, on the copy of its node if there is one.
+     */
+    View getLocal() const;
+};
+
+#endif //JUDICIOUSPARTITIONING_NUMAPLACEMENT_H
@@ -0,0 +1,71 @@
+#ifndef JUDICIOUSPARTITIONING_PARTITIONEVALUATOR_H
+#define JUDICIOUSPARTITIONING_PARTITIONEVALUATOR_H
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "DataDistribution.h"
+
+/**
+ * The quality of a data distribution. The load of a CPU is the number of repeat classes (RCC) it holds, summed over
+ * the partitions it got sites of, as the phylogenetic inference computes each of them once per CPU.
+ */
+struct PartitionQuality {
+    std::vector<size_t> repeatClassesOfBlock;
+    std::vector<size_t> sitesOfBlock;
+    // The repeat classes of all partitions of the distribution, no distribution can put fewer on all CPUs together
+    size_t totalRepeatClasses = 0;
+
+    // ##### Getters/Setters
+    size_t getWorst() const;
+    double getAverage() const;
+
+    /**
+     * @return How far the worst CPU is above the average one, 0 if all have the same load.
+     */
+    double getImbalance() const;
+
+    /**
+     * @return The smallest worst RCC any distribution of the same partitions to as many CPUs can have.
+     */
+    size_t getWorstLowerBound() const;
+};
+
+/**
+ * Computes the quality of data distributions on the hypergraphs of a repeats file. The hyperedges of each site are
+ * kept in one array per partition, and each thread counts the distinct ones of a CPU with an array of stamps over the
+ * hyperedges, so a CPU costs the number of repeat classes of its sites and nothing is cleared in between.
+ */
+class PartitionEvaluator {
+private:
+    struct Partition {
+        // The hyperedges of site s are hyperedges[offsets[s]] to hyperedges[offsets[s + 1] - 1]
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> hyperedges;
+        size_t numHyperedges = 0;
+    };
+
+    std::map<uint32_t, Partition> partitions;
+
+public:
+    // ##### Constructors
+    /**
+     * Loads the given partitions of a repeats file in one pass. Throws a std::runtime_error if the file does not have
+     * one of them.
+     */
+    PartitionEvaluator(const std::string &repeatsPath, const std::set<uint32_t> &partitionNumbers);
+
+    // ##### Functions
+    /**
+     * Counts the repeat classes and sites of each CPU, the CPUs in parallel.
+     *
+     * @return False if the distribution has a partition that was not loaded or a site that the partition does not
+     * have, or leaves a site of one of its partitions out.
+     */
+    bool evaluate(const DataDistribution &distribution, PartitionQuality &quality) const;
+};
+
+#endif //JUDICIOUSPARTITIONING_PARTITIONEVALUATOR_H
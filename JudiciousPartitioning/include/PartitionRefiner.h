@@ -0,0 +1,48 @@
+#ifndef JUDICIOUSPARTITIONING_PARTITIONREFINER_H
+#define JUDICIOUSPARTITIONING_PARTITIONREFINER_H
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "Algorithms.h"
+#include "Hypergraph.h"
+#include "SitePartitioning.h"
+
+/**
+ * Lowers the maximum load of a partitioning, the number of hyperedges that the sites of a block touch, by moving
+ * sites between blocks. Sites with the same hyperedges form a group that always moves as a whole, as every block of
+ * the algorithm holds either all or none of them. Each hyperedge keeps the blocks on it with the number of their
+ * groups there, so a move costs the degree of its group times the blocks on its hyperedges. The refinement runs in passes: the best target of each
+ * group in a block with the maximum load is searched in parallel, then the moves that still lower the load of their
+ * block are applied one after the other.
+ */
+class PartitionRefiner {
+private:
+    // The hyperedges of each group, ascending
+    std::vector<std::vector<uint32_t>> hyperedgesOfGroup;
+    // The sites of each group, ascending
+    std::vector<std::vector<uint32_t>> sitesOfGroup;
+    size_t numHyperedges;
+
+public:
+    // ##### Constructors
+    explicit PartitionRefiner(const Hypergraph &hypergraph);
+
+    // ##### Functions
+    /**
+     * Moves groups out of the blocks with the maximum load as long as this lowers their load without raising another
+     * block to it, for at most as many passes as there are groups or until the deadline. The result never has a
+     * higher maximum load than the input.
+     */
+    void refine(SitePartitioning &partitioning,
+                std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max()) const;
+
+    /**
+     * @return A consumer that refines each partitioning for at most options.refinementTime seconds before it hands it
+     * on. Refers to options and consumer, which have to outlive it.
+     */
+    PartitioningConsumer wrap(const PartitionOptions &options, const PartitioningConsumer &consumer) const;
+};
+
+#endif //JUDICIOUSPARTITIONING_PARTITIONREFINER_H
@@ -0,0 +1,39 @@
+#ifndef JUDICIOUSPARTITIONING_PARTITIONSTATE_H
+#define JUDICIOUSPARTITIONING_PARTITIONSTATE_H
+
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "EElem.h"
+#include "MergeHierarchy.h"
+
+/**
+ * Where partition stands after a round: the number d of the round, its S*, which is the E of the next round, and the
+ * blocks of all rounds so far. partition can continue from such a state with the same results as an uninterrupted
+ * run. A state with d = 0 has no rounds yet.
+ */
+struct PartitionState {
+    size_t d = 0;
+    // False once a round used the approximate candidate search, all later rounds are approximate too
+    bool exact = true;
+    std::vector<EElem> e;
+    MergeHierarchy::Recorder recorder;
+
+    // ##### Constructors
+    PartitionState() = default;
+
+    /**
+     * Reads a state in the binary format of writeTo. Sets the failbit of the stream if it ends early.
+     */
+    explicit PartitionState(std::istream &stream);
+
+    // ##### Functions
+    /**
+     * Writes the state in a compact binary format: d, whether it is exact, the number of elements of e and the
+     * elements, then the recorder.
+     */
+    void writeTo(std::ostream &stream) const;
+};
+
+#endif //JUDICIOUSPARTITIONING_PARTITIONSTATE_H
@@ -0,0 +1,66 @@
+#ifndef JUDICIOUSPARTITIONING_PERFCOUNTERS_H
+#define JUDICIOUSPARTITIONING_PERFCOUNTERS_H
+
+#include <array>
+#include <cstdint>
+#include <tbb/task_arena.h>
+#include <tbb/task_scheduler_observer.h>
+
+// Number of hardware events in a counter group
+#define NUM_PERF_EVENTS 4
+
+/**
+ * Hardware performance counters of all threads of the process, through perf_event_open. Every thread that takes part
+ * in the run opens its own group of counters for cycles, instructions, last level cache misses and branch misses, and
+ * read sums up the groups of all threads. Counters that the kernel multiplexes are scaled to the full time. A group is
+ * closed when its thread ends, its last counts stay in the sums.
+ */
+class PerfCounters {
+public:
+    using Sample = std::array<uint64_t, NUM_PERF_EVENTS>;
+
+    /**
+     * Opens counter groups for each thread that enters the arena.
+     */
+    class ThreadObserver : public tbb::task_scheduler_observer {
+    public:
+        // ##### Constructors
+        explicit ThreadObserver(tbb::task_arena &arena);
+        ~ThreadObserver() override;
+
+        // ##### Functions
+        void on_scheduler_entry(bool isWorker) override;
+    };
+
+    // ##### Getters/Setters
+    /**
+     * @return The names of the events in the order of a Sample.
+     */
+    static const std::array<const char *, NUM_PERF_EVENTS> &getEventNames();
+
+    /**
+     * @return True if enable succeeded, so the Profiler should sample the counters.
+     */
+    static bool isEnabled();
+
+    // ##### Functions
+    /**
+     * Opens the counters of the calling thread.
+     *
+     * @return False if the hardware or the kernel do not provide the counters, e.g. in a virtual machine or with a
+     * restrictive perf_event_paranoid setting. The counters stay disabled then.
+     */
+    static bool enable();
+
+    /**
+     * Opens the counters of the calling thread if they are enabled and not open on this thread yet.
+     */
+    static void attachThread();
+
+    /**
+     * @return The current counts summed over all threads with open counters.
+     */
+    static Sample read();
+};
+
+#endif //JUDICIOUSPARTITIONING_PERFCOUNTERS_H
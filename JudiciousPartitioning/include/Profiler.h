@@ -0,0 +1,105 @@
+#ifndef JUDICIOUSPARTITIONING_PROFILER_H
+#define JUDICIOUSPARTITIONING_PROFILER_H
+
+#include <cstdint>
+#include <iostream>
+#include <string>
+
+/**
+ * Registry of phase timings. Each thread keeps its own stack of running phases and its own records, so timing a
+ * phase only locks the uncontended mutex of the calling thread. A phase started while another one runs on the same
+ * thread is nested into it, its path is the names of all running phases joined with '/'. A thread that waits inside a
+ * phase may run a task taken from another one, e.g. the output of the previous round while generateS waits for its
+ * loop. Such tasks detach from the phases below them with DetachedPhases, so their phases get the same paths on any
+ * thread. Each phase also records the allocations of all threads between its start and stop, the phases of the main
+ * thread also the high-water mark of the live heap bytes (see MemoryAccounting). If PerfCounters are enabled, it
+ * records the hardware events too.
+ */
+class Profiler {
+public:
+    // ##### Functions
+    /**
+     * Starts a phase on the calling thread, nested into the phase running there.
+     */
+    static void start(const std::string &name);
+
+    /**
+     * Stops the innermost running phase of the calling thread. Throws a std::logic_error if that phase has another
+     * name.
+     */
+    static void stop(const std::string &name);
+
+    /**
+     * Like stop, but reports an error on stderr instead of throwing it, so destructors can call it. Asserts in debug
+     * builds.
+     *
+     * @return False if the phase could not be stopped, the running phases are then unchanged.
+     */
+    static bool stopNoThrow(const std::string &name) noexcept;
+
+    /**
+     * Starts a task on the calling thread whose phases are not nested into the ones running there, until attach.
+     */
+    static void detach();
+
+    /**
+     * Ends the task of the last detach, after all of its phases stopped.
+     */
+    static void attach();
+
+    /**
+     * Prints the total time of each top level phase over all threads, the one named mainPhase to mainStream and the
+     * others to stream. Throws a std::logic_error if the calling thread still runs a phase.
+     */
+    static void printSummary(std::ostream &stream, const std::string &mainPhase, std::ostream &mainStream);
+
+    /**
+     * Writes the records of all phases as JSON: one entry per path and thread, plus one entry over all threads for
+     * each path that ran on several of them. Call only while no other thread times phases.
+     */
+    static void writeJson(std::ostream &stream);
+
+    /**
+     * Writes the records of all phases as CSV with the same rows as writeJson.
+     */
+    static void writeCsv(std::ostream &stream);
+
+    /**
+     * Writes the records to a file, as CSV if the path ends in .csv and as JSON otherwise.
+     *
+     * @return False if the file could not be written.
+     */
+    static bool dump(const std::string &path);
+};
+
+/**
+ * Times a phase for the lifetime of the object.
+ */
+class ScopedPhase {
+private:
+    std::string name;
+
+public:
+    // ##### Constructors
+    explicit ScopedPhase(std::string name);
+    ~ScopedPhase();
+
+    ScopedPhase(const ScopedPhase &) = delete;
+    ScopedPhase &operator=(const ScopedPhase &) = delete;
+};
+
+/**
+ * Detaches the phases of a task from the phases of the thread that runs it for the lifetime of the object, see
+ * Profiler::detach. Create it first thing in a task that may be taken by a thread waiting inside a phase.
+ */
+class DetachedPhases {
+public:
+    // ##### Constructors
+    DetachedPhases();
+    ~DetachedPhases();
+
+    DetachedPhases(const DetachedPhases &) = delete;
+    DetachedPhases &operator=(const DetachedPhases &) = delete;
+};
+
+#endif //JUDICIOUSPARTITIONING_PROFILER_H
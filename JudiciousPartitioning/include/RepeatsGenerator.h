@@ -0,0 +1,65 @@
+#ifndef JUDICIOUSPARTITIONING_REPEATSGENERATOR_H
+#define JUDICIOUSPARTITIONING_REPEATSGENERATOR_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Hypergraph.h"
+
+enum class RepeatClassDistribution {
+    // Each site falls into each of the repeat classes of a row with the same probability
+    UNIFORM,
+    // Class i gets a share proportional to 1 / (i + 1), so a few large classes dominate as in real alignments
+    ZIPF
+};
+
+/**
+ * @return True and sets distribution if name is uniform or zipf, false otherwise.
+ */
+bool parseRepeatClassDistribution(const std::string &name, RepeatClassDistribution &distribution);
+
+/**
+ * Creates random partitions in the repeats format, for benchmarks without an alignment and a tree. The same
+ * parameters and seed always create the same partition.
+ */
+class RepeatsGenerator {
+private:
+    size_t numSites;
+    size_t numRows;
+    size_t numRepeatClasses;
+    RepeatClassDistribution distribution;
+    double duplicateSiteRatio;
+    uint64_t seed;
+
+public:
+    // ##### Constructors
+    /**
+     * @param numSites The number of sites (hypernodes) of the partition.
+     * @param numRows The number of rows, i.e. internal nodes of the tree. It is the hyperdegree cm of the result.
+     * @param numRepeatClasses The maximum number of repeat classes per row.
+     * @param distribution How the sites are spread over the repeat classes of a row.
+     * @param duplicateSiteRatio The share of sites that copy the classes of an earlier site in all rows, these become
+     * duplicates in E.
+     * @param seed The seed of the random number generator.
+     */
+    RepeatsGenerator(size_t numSites, size_t numRows, size_t numRepeatClasses, RepeatClassDistribution distribution,
+                     double duplicateSiteRatio, uint64_t seed);
+
+    // ##### Functions
+    /**
+     * @return One row per internal node with the repeat class of each site, numbered 0, 1, 2, ... in the order of
+     * their first site as in converted alignments.
+     */
+    std::vector<std::vector<uint32_t>> generateRows() const;
+
+    Hypergraph generateHypergraph() const;
+
+    /**
+     * Writes the partition as a repeats file with the single partition partition_0.
+     */
+    void writeTo(std::ostream &stream) const;
+};
+
+#endif //JUDICIOUSPARTITIONING_REPEATSGENERATOR_H
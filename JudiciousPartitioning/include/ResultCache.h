@@ -0,0 +1,64 @@
+#ifndef JUDICIOUSPARTITIONING_RESULTCACHE_H
+#define JUDICIOUSPARTITIONING_RESULTCACHE_H
+
+#include <cstdint>
+#include <string>
+
+#include "Hypergraph.h"
+#include "PartitionState.h"
+
+/**
+ * Keeps the state of the last partition run of each hypergraph in a directory, one file per hypergraph. Loading it
+ * before the next run of the same hypergraph hands out all ks its rounds reached without running generateS again,
+ * and continues from its last round for the smaller ks. Files of other builds, i.e. with another bit representation
+ * or another set of DETERMINISM and FAKE_DETECTION, and of runs with the other locality reordering setting have other
+ * keys.
+ *
+ * The other runtime options are not part of the key. The rounds do not depend on the number of threads or ranks, the memory
+ * budget or the NUMA mode: S is sorted by combination, the minimal distances break ties by the smaller index and the
+ * fill-up of findMinimalSubset appends its elements in the order of E. Each file also holds the number of sites,
+ * hyperedges and pins of its hypergraph and a second hash, which load checks, so two hypergraphs whose keys collide
+ * are a miss instead of a wrong result. The files are little endian on any host, and a truncated or damaged file is a
+ * miss as well.
+ */
+class ResultCache {
+private:
+    std::string directory;
+    bool localityReordering;
+
+    std::string getPath(uint64_t key) const;
+
+public:
+    // ##### Constructors
+    /**
+     * Creates the directory if it does not exist. Throws a std::runtime_error if it cannot be created.
+     *
+     * @param localityReordering The locality reordering setting of the runs whose states are loaded and stored.
+     */
+    explicit ResultCache(const std::string &directory, bool localityReordering = false);
+
+    // ##### Functions
+    /**
+     * @return The key of a hypergraph, a hash of its sites and hyperedges, of the build and of the locality reordering
+     * setting.
+     */
+    static uint64_t getKey(const Hypergraph &hypergraph, bool localityReordering);
+
+    /**
+     * Loads the state stored for a hypergraph. A missing or unreadable file is a miss, and so is a file of another
+     * hypergraph with the same key.
+     *
+     * @return False on a miss, state is then unchanged.
+     */
+    bool load(const Hypergraph &hypergraph, PartitionState &state) const;
+
+    /**
+     * Stores the state for a hypergraph, replacing the previous one. States with approximate rounds are not stored.
+     * Writes a temporary file and renames it, so concurrent runs never read a partial file.
+     *
+     * @return False if it could not be written.
+     */
+    bool store(const Hypergraph &hypergraph, const PartitionState &state) const;
+};
+
+#endif //JUDICIOUSPARTITIONING_RESULTCACHE_H
@@ -14,6 +14,12 @@ class SElem {
 private:
     BitRepresentation combination;
 
+    /**
+     * Hash of the combination, calculated once on construction. Merging only touches the covered sets, so it stays
+     * valid for the lifetime of the element.
+     */
+    uint64_t combinationHash{};
+
     /**
      * Elements of the e set in the current iteration that are covered by this combination.
      */
@@ -38,7 +44,20 @@ public:
                    const std::set<uint32_t> &left,
                    const std::set<uint32_t> &right) noexcept;
 
+    /**
+     * Construct from a combination and both covered sets, e.g. after merging spilled runs.
+     */
+    SElem(BitRepresentation &&combination, std::set<uint32_t> coveredEElems, std::set<uint32_t> coveredE0Elems);
+
+    /**
+     * Reads an element in the binary format of writeTo. Sets the failbit of the stream if it ends early.
+     */
+    explicit SElem(std::istream &stream);
+
     // ##### Operators
+    /**
+     * Compares the cached hashes first and the combinations only on a hash match.
+     */
     bool operator==(const SElem &rhs) const;
     bool operator!=(const SElem &rhs) const;
 
@@ -58,17 +77,28 @@ public:
     BitRepresentation &getCombination();
     std::set<uint32_t> &getCoveredEElems();
     std::set<uint32_t> &getCoveredE0Elems();
+    uint64_t getHash() const;
+
+    /**
+     * @return The estimated number of bytes this element occupies, including the nodes of its covered sets.
+     */
+    size_t getMemoryUsage() const;
 
     // ##### Functions
     bool covers(const SElem &rhs) const;
     bool covers(const BitRepresentation &rhs) const;
     size_t countOnes() const;
+
+    /**
+     * Writes the element in a compact binary format: the combination followed by both covered sets.
+     */
+    void writeTo(std::ostream &stream) const;
 };
 
 namespace std {
     template <> struct hash<SElem> {
         size_t operator()(const SElem &s) const {
-            return std::hash<BitRepresentation>{}(s.getCombination());
+            return s.getHash();
         }
     };
 }
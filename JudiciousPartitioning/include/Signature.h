@@ -0,0 +1,52 @@
+#ifndef JUDICIOUSPARTITIONING_SIGNATURE_H
+#define JUDICIOUSPARTITIONING_SIGNATURE_H
+
+#include "Definitions.h"
+
+#include <array>
+#include <cstdint>
+
+/**
+ * Small sketch of a combination: the bitvector folded onto SIGNATURE_WORDS words with xor. Every bit of the
+ * combination lands on exactly one bit of the signature, so the hamming distance of two signatures is a lower bound
+ * for the hamming distance of the two combinations.
+ */
+class Signature {
+private:
+    std::array<uint64_t, SIGNATURE_WORDS> words{};
+
+public:
+    // ##### Constructors
+    /**
+     * Constructs the signature of the empty combination.
+     */
+    Signature() = default;
+
+    explicit Signature(const AlignedBitArray &combination);
+    explicit Signature(const SparseBitVector &combination);
+
+    // ##### Operators
+    Signature operator|(const Signature &rhs) const;
+    Signature operator&(const Signature &rhs) const;
+
+    // ##### Functions
+    /**
+     * Calculates a lower bound for the distance of the two combinations this and rhs were built from.
+     *
+     * @param rhs The signature of the other combination.
+     * @return A value that is never greater than the distance of the combinations.
+     */
+    size_t distanceLowerBound(const Signature &rhs) const;
+
+    /**
+     * Calculates a lower bound for the distance of the combination this was built from to each combination of a group.
+     * A bit differs for the whole group if it is set here but in none of the group, or unset here but in all of it.
+     *
+     * @param groupOr The signatures of the group combined with operator|.
+     * @param groupAnd The signatures of the group combined with operator&.
+     * @return A value that is never greater than the distance to any combination in the group.
+     */
+    size_t distanceLowerBound(const Signature &groupOr, const Signature &groupAnd) const;
+};
+
+#endif //JUDICIOUSPARTITIONING_SIGNATURE_H
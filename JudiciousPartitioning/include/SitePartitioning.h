@@ -0,0 +1,25 @@
+#ifndef JUDICIOUSPARTITIONING_SITEPARTITIONING_H
+#define JUDICIOUSPARTITIONING_SITEPARTITIONING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * A partitioning of the sites of a partition into k blocks, one block per CPU.
+ */
+struct SitePartitioning {
+    size_t k = 0;
+    // The block of each site, between 0 and k - 1. Blocks can be empty if there are fewer distinct sites than k.
+    std::vector<uint32_t> blockOfSite;
+    // False if the blocks come from an approximate round or the fallback merge after the time budget ran out, or from
+    // the multilevel engine
+    bool exact = true;
+
+    /**
+     * @return The sites of each block in ascending order, k blocks in total.
+     */
+    std::vector<std::vector<size_t>> getBlocks() const;
+};
+
+#endif //JUDICIOUSPARTITIONING_SITEPARTITIONING_H
@@ -2,6 +2,7 @@
 #define JUDICIOUSCPPOPTIMIZED_SPARSEBITVECTOR_H
 
 #include <cstdlib>
+#include <iostream>
 #include <boost/functional/hash.hpp>
 
 #ifdef __AVX512F__
@@ -25,6 +26,12 @@ public:
     SparseBitVector() = default;
 
     explicit SparseBitVector(size_t numBits);
+
+    /**
+     * Reads a vector in the binary format of writeTo. Sets the failbit of the stream if it ends early.
+     */
+    explicit SparseBitVector(std::istream &stream);
+
     SparseBitVector(const SparseBitVector &other);
     SparseBitVector(SparseBitVector &&other) noexcept;
 
@@ -44,6 +51,11 @@ public:
     size_t getNumBits() const;
     const std::vector<uint32_t> &getBitarray() const;
 
+    /**
+     * @return The number of bytes this vector occupies, including its heap buffer.
+     */
+    size_t getMemoryUsage() const;
+
     /**
      * Sets the bit at index i to 1. 0 is the LSB, numBits-1 is the MSB.
      *
@@ -56,16 +68,34 @@ public:
     bool covers(const SparseBitVector &rhs) const;
     size_t calculateDistance(const SparseBitVector &rhs) const;
     void setRightmost(const SparseBitVector &rhs);
+
+    /**
+     * Calculates a 64 bit hash over the set bit indices. This is not cached, store the result if it is needed more
+     * than once.
+     *
+     * @return The hash value.
+     */
+    uint64_t hash() const;
+
+    /**
+     * Compares by the rank in the binary reflected gray code, most significant bit first. Neighbours in this order
+     * tend to differ in few bits, unlike in the plain numerical order of operator<.
+     *
+     * @param rhs The vector to compare with.
+     * @return True if this vector comes before rhs in gray code order.
+     */
+    bool grayCodeLess(const SparseBitVector &rhs) const;
+
+    /**
+     * Writes the vector in a compact binary format: the number of bits, the number of set bits and their indices.
+     */
+    void writeTo(std::ostream &stream) const;
 };
 
 namespace std {
     template <> struct hash<SparseBitVector> {
         size_t operator()(const SparseBitVector &array) const {
-            size_t result = 0;
-            for (size_t i = 0; i < array.getBitarray().size(); i++) {
-                boost::hash_combine(result, std::hash<uint32_t>{}(array.getBitarray()[i]));
-            }
-            return result;
+            return array.hash();
         }
     };
 }
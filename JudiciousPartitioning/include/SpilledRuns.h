@@ -0,0 +1,50 @@
+#ifndef JUDICIOUSPARTITIONING_SPILLEDRUNS_H
+#define JUDICIOUSPARTITIONING_SPILLEDRUNS_H
+
+#include "SElem.h"
+
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * Sorted runs of partial S sets in temporary files. generateS spills its concurrent set into a run whenever it grows
+ * over the memory budget and merges all runs into the final S at the end.
+ */
+class SpilledRuns {
+private:
+    std::string directory;
+    std::vector<std::unique_ptr<std::fstream>> runs;
+
+public:
+    // ##### Constructors
+    /**
+     * @param directory The directory to create the temporary files in. They are unlinked right after creation.
+     */
+    explicit SpilledRuns(std::string directory);
+
+    // ##### Getters/Setters
+    bool empty() const;
+    size_t size() const;
+
+    // ##### Functions
+    /**
+     * Sorts the elements by combination and writes them into a new run. Throws a std::runtime_error if the run cannot
+     * be written.
+     */
+    void spill(std::vector<SElem> &&run);
+
+    /**
+     * Merges all runs and the elements that were not spilled. Elements with the same combination are combined by
+     * merging their covered sets, just like generateS does when inserting into its set. Removes all runs.
+     *
+     * Throws a std::runtime_error if a run cannot be read.
+     *
+     * @param remaining The elements that are still in memory.
+     * @return The merged set S, sorted by combination.
+     */
+    std::vector<SElem> merge(std::vector<SElem> &&remaining);
+};
+
+#endif //JUDICIOUSPARTITIONING_SPILLEDRUNS_H
@@ -0,0 +1,69 @@
+#ifndef JUDICIOUSPARTITIONING_TELEMETRY_H
+#define JUDICIOUSPARTITIONING_TELEMETRY_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * What happened in one round of partition. The phases fill it in whether telemetry is written or not, which only
+ * costs a few counters per round.
+ */
+struct RoundStatistics {
+    size_t d = 0;
+    size_t cmPlusD = 0;
+    size_t sizeE = 0;
+    size_t sizeS = 0;
+    size_t sizeSStar = 0;
+    // Pairs of E with distance 2 that generateS found, including the ones merged into an existing element of S
+    uint64_t numDistanceTwoPairs = 0;
+    // Elements of S* that findMinimalSubset created in the fill-up instead of taking them from S
+    size_t numFillUps = 0;
+    // Runs generateS spilled to disk because of the memory budget
+    size_t numSpilledRuns = 0;
+    uint64_t generateSNanoseconds = 0;
+    uint64_t findMinimalSubsetNanoseconds = 0;
+    uint64_t roundNanoseconds = 0;
+    // High-water mark of the resident memory of the process so far
+    size_t peakResidentBytes = 0;
+    // High-water mark of the counted live heap bytes of the process during this round, see MemoryAccounting
+    int64_t peakLiveBytes = 0;
+    uint64_t numAllocations = 0;
+    // Estimated bytes of the main containers: E, the part of E in the sets of covered original elements, S after
+    // generateS and the minimal distances
+    size_t bytesE = 0;
+    size_t bytesCoveredE0Elems = 0;
+    size_t bytesS = 0;
+    size_t bytesMinimalDistances = 0;
+    // True if the time budget made this round use the approximate candidate search instead of generateS
+    bool approximate = false;
+    // The ks whose partitions this round found
+    std::vector<size_t> ks;
+};
+
+/**
+ * Writes one JSON object per round and line. Each line is flushed right away, so the records up to a crash or a
+ * killed job are kept.
+ */
+class TelemetryWriter {
+private:
+    std::ofstream file;
+
+public:
+    // ##### Constructors
+    /**
+     * Throws a std::runtime_error if the file cannot be created.
+     */
+    explicit TelemetryWriter(const std::string &path);
+
+    // ##### Functions
+    void write(const RoundStatistics &statistics);
+
+    /**
+     * @return The high-water mark of the resident memory of the process in bytes.
+     */
+    static size_t getPeakResidentBytes();
+};
+
+#endif //JUDICIOUSPARTITIONING_TELEMETRY_H
@@ -1,9 +1,15 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
 #include <iostream>
 #include <fstream>
-#include <omp.h>
-#include <tbb/concurrent_unordered_map.h>
+#include <stdexcept>
+#include <tbb/blocked_range.h>
 #include <tbb/concurrent_unordered_set.h>
-#include <tbb/concurrent_vector.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_sort.h>
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/range/algorithm/set_algorithm.hpp>
 
@@ -12,29 +18,35 @@
 #include "EElem.h"
 #include "AlignedBitArray.h"
 #include "SparseBitVector.h"
+#include "Signature.h"
+#include "MinimalDistances.h"
+#include "SpilledRuns.h"
+#include "NumaPlacement.h"
+#include "Distributed.h"
+#include "Profiler.h"
+#include "PerfCounters.h"
+#include "Telemetry.h"
+#include "MemoryAccounting.h"
+#include "MergeHierarchy.h"
+#include "ResultCache.h"
+#include "Checkpoint.h"
 #include "Helper.h"
 #include "Algorithms.h"
 
-// Key is the index of the element e that maps to the minimal distance element
-// Value is a pair where
-// * the first value is the index of the element if e with a minimal distance to the key element
-// * the second value is the minimal distance
-tbb::concurrent_unordered_map<size_t, std::pair<size_t, size_t>> minimalDistances;
-
 /**
  * Parse a partition file and create its hypergraph.
  * @param filepath The path to the partition file.
  * @param partitionNumber The number of the partition that should be extracted from the file. 0 is the first partition.
  * When in doubt, use 0 :)
  * @return The hypergraph that represents the partition described in the input file.
+ * @throws std::runtime_error If the file cannot be opened or does not have the partition.
  */
 Hypergraph getHypergraphFromPartitionFile(const std::string &filepath, uint32_t partitionNumber) {
     // Read the file
     std::ifstream input_file(filepath);
 
-    if (input_file.bad()) {
-        std::cout << "Could not read " << filepath << std::endl;
-        exit(1);
+    if (!input_file.is_open()) {
+        throw std::runtime_error("Could not read " + filepath);
     }
 
     // We will create a 2D array containing the information from the file
@@ -74,55 +86,145 @@ Hypergraph getHypergraphFromPartitionFile(const std::string &filepath, uint32_t
         }
     }
 
-    // Now create the hypergraph from the 2D array
-    std::vector<uint32_t> hypernodes;
-    std::vector<hElem> hyperedges;
-
-    unsigned long numberOfSites = partition[0].size();
-    assert(numberOfSites == numberOfSitesFromFile);
+    if (partition.empty()) {
+        throw std::runtime_error(filepath + " does not have partition_" + std::to_string(partitionNumber));
+    }
+    assert(partition[0].size() == numberOfSitesFromFile);
 
+    return Hypergraph::fromRepeatClasses(partition);
+}
 
-    // Fill the hypernodes
-    for (uint32_t j = 0; j < numberOfSites; j++) {
-        hypernodes.push_back(j);
+/**
+ * Parse the partitions of a partition file in one pass and create their hypergraphs in parallel.
+ * @param filepath The path to the partition file.
+ * @param partitionNumbers The numbers of the partitions that should be extracted from the file.
+ * @return The hypergraph of each of these partitions that the file has.
+ * @throws std::runtime_error If the file cannot be opened.
+ */
+std::map<uint32_t, Hypergraph> getHypergraphsFromPartitionFile(const std::string &filepath, const std::set<uint32_t> &partitionNumbers) {
+    std::ifstream input_file(filepath);
+    if (!input_file.is_open()) {
+        throw std::runtime_error("Could not read " + filepath);
     }
 
-    // Fill the hyperedges
-    hElem curHyperedge;
-    for (std::vector<uint32_t> curLine : partition) {  // Traverse all lines (rows in the partition)
-        // Can have a maximum of numberOfSites repeat classes per row:
-        for (uint32_t curRepeatClass = 0; curRepeatClass < numberOfSites; curRepeatClass++) {
-            curHyperedge.clear();
-            for (uint32_t k = 0; k < numberOfSites; k++) {  // Traverse all sites (columns in the partition)
-                if (curLine[k] == curRepeatClass) {
-                    curHyperedge.push_back(k);
-                }
-            }
-            if (!curHyperedge.empty()) {
-                hyperedges.push_back(curHyperedge);
-            } else {  // No site contains curRepeatClass --> none will contain any "higher" repeat class
-                break;
+    // Only the rows of the wanted partitions are parsed, the others are skipped line by line
+    std::map<uint32_t, std::vector<std::vector<uint32_t>>> rowsOfPartition;
+    std::vector<std::vector<uint32_t>> *rows = nullptr;
+    std::string line;
+    std::getline(input_file, line);  // The number of partitions and rows
+    while (std::getline(input_file, line)) {
+        if (boost::starts_with(line, "partition")) {
+            uint32_t partitionNumber = stringToUint32t(line.substr(10));
+            rows = partitionNumbers.count(partitionNumber) != 0 ? &rowsOfPartition[partitionNumber] : nullptr;
+        } else if (rows != nullptr) {
+            rows->emplace_back();
+            const char *begin = line.c_str();
+            char *end = nullptr;
+            for (unsigned long repeatClass = strtoul(begin, &end, 10); end != begin; repeatClass = strtoul(begin, &end, 10)) {
+                rows->back().push_back(static_cast<uint32_t>(repeatClass));
+                begin = end;
             }
         }
     }
 
-    assert(hypernodes.size() == numberOfSitesFromFile);
+    std::vector<std::map<uint32_t, std::vector<std::vector<uint32_t>>>::const_iterator> partitions;
+    for (auto partition = rowsOfPartition.cbegin(); partition != rowsOfPartition.cend(); partition++) {
+        partitions.push_back(partition);
+    }
+    std::vector<Hypergraph> hypergraphs(partitions.size(), Hypergraph({}, {}));
+    tbb::parallel_for(size_t(0), partitions.size(), [&](size_t i) {
+        hypergraphs[i] = Hypergraph::fromRepeatClasses(partitions[i]->second);
+    });
+
+    std::map<uint32_t, Hypergraph> result;
+    for (size_t i = 0; i < partitions.size(); i++) {
+        result.emplace(partitions[i]->first, std::move(hypergraphs[i]));
+    }
+    return result;
+}
+
 
-    return Hypergraph(std::move(hypernodes), std::move(hyperedges));
+bool parseEngine(const std::string &name, Engine &engine) {
+    if (name == "exact") {
+        engine = Engine::EXACT;
+    } else if (name == "multilevel") {
+        engine = Engine::MULTILEVEL;
+    } else {
+        return false;
+    }
+    return true;
 }
 
+/**
+ * Orders E by the gray code rank of the combinations, so that elements which differ in few bits end up next to each
+ * other.
+ *
+ * @param e The set E as described in generateE.
+ * @return The indices of e in locality order.
+ */
+std::vector<uint32_t> getLocalityOrder(const std::vector<EElem> &e) {
+    std::vector<uint32_t> order(e.size());
+    for (uint32_t eidx = 0; eidx < e.size(); eidx++) {
+        order[eidx] = eidx;
+    }
+    std::sort(order.begin(), order.end(), [&e](uint32_t lhs, uint32_t rhs) {
+        return e[lhs].getCombination().grayCodeLess(e[rhs].getCombination());
+    });
+    return order;
+}
 
-void printDDF(size_t k, const std::vector<std::vector<size_t>> &partitions) {
-    std::cout << k << std::endl;
-    size_t partitionCounter = 1;
-    for (const std::vector<size_t> &partition : partitions) {
-        std::cout << "CPU" << partitionCounter++ << " 1" << std::endl;
-        std::cout << "partition_0 " << partition.size();
-        for (size_t hypernode : partition) {
-            std::cout << " " << hypernode;
+/**
+ * Reorders E into locality order. Similar elements then share the tiles of the pair loop in generateS, so whole tiles
+ * can be skipped, and the rows touched for one firstEidx are more likely to be in cache. Changes the indices into E,
+ * so ties between equally good candidates can be broken differently than without reordering.
+ *
+ * @param e The set E as described in generateE.
+ */
+void reorderForLocality(std::vector<EElem> &e) {
+    std::vector<uint32_t> order = getLocalityOrder(e);
+    std::vector<EElem> reordered;
+    reordered.reserve(e.size());
+    for (uint32_t eidx : order) {
+        reordered.push_back(std::move(e[eidx]));
+    }
+    e = std::move(reordered);
+}
+
+/**
+ * Splits the rows of the pair triangle over e into blocks with about the same number of pairs.
+ *
+ * @param numElements The size of e.
+ * @param numBlocks The wanted number of blocks.
+ * @return The first row of each block, followed by numElements.
+ */
+std::vector<size_t> getPairBlocks(size_t numElements, size_t numBlocks) {
+    std::vector<size_t> blockBegins = { 0 };
+    if (numBlocks > 1) {
+        size_t numPairs = numElements * (numElements - 1) / 2;
+        size_t pairsSoFar = 0;
+        for (size_t row = 0; row + 1 < numElements; row++) {
+            pairsSoFar += numElements - row - 1;
+            if (pairsSoFar * numBlocks >= numPairs * blockBegins.size()) {
+                blockBegins.push_back(row + 1);
+            }
         }
-        std::cout << std::endl;
     }
+    if (blockBegins.back() != numElements) {
+        blockBegins.push_back(numElements);
+    }
+    return blockBegins;
+}
+
+/**
+ * Estimates the memory used by the concurrent set S in generateS.
+ */
+static size_t getMemoryUsage(const tbb::concurrent_unordered_set<SElem, std::hash<SElem>> &s) {
+    // Each element sits in a list node with a next pointer and an order key, plus one bucket pointer per element
+    size_t result = s.size() * 3 * sizeof(void *);
+    for (const SElem &currentS : s) {
+        result += currentS.getMemoryUsage();
+    }
+    return result;
 }
 
 /**
@@ -131,115 +233,292 @@ void printDDF(size_t k, const std::vector<std::vector<size_t>> &partitions) {
  *
  * @param cmPlusD The number of elements in a combination.
  * @param e The set e as described in generateE.
- * @return The set S.
+ * @param options The memory budget, spill directory and NUMA mode are used.
+ * @param minimalDistances Gets the minimal distance of each element of e that has no partner at distance 2, and on all
+ * ranks the same.
+ * @param statistics Gets the size and memory of S and of the minimal distances, the number of distance 2 pairs and the
+ * number of spilled runs. Its approximate flag is set if the deadline passed.
+ * @param deadline When the pair loop gives up. All ranks give up together, S is then empty and useless.
+ * @return The set S, sorted by combination.
  */
-std::vector<SElem> generateS(size_t cmPlusD, const std::vector<EElem> &e) {
+std::vector<SElem> generateS(size_t cmPlusD, const std::vector<EElem> &e, const PartitionOptions &options, MinimalDistances &minimalDistances,
+                             RoundStatistics &statistics, std::chrono::steady_clock::time_point deadline) {
     assert(cmPlusD < INT32_MAX);
     assert(!e.empty());
+    ScopedPhase phase("generateS");
 
     DEBUG_LOG(DEBUG_PROGRESS, "Generating S(>=2)... ");
     DEBUG_LOG(DEBUG_VERBOSE, "\n");
 
     tbb::concurrent_unordered_set<SElem, std::hash<SElem>> s;
-    minimalDistances.clear();
-
-    // Run over all possible pairs in E and check if they build a possible combination
-    #pragma omp parallel for schedule(dynamic)
-    for (uint32_t firstEidx = 0; firstEidx < e.size(); firstEidx++) {
-    #if DEBUG >= DEBUG_VERBOSE && _OPENMP
-        if (omp_get_thread_num() == 0) DEBUG_LOG(DEBUG_PROGRESS, "Running loop for firstEidx " + std::to_string(firstEidx) + "\r");
-    #elif DEBUG >= DEBUG_VERBOSE
-        if (firstEidx % 10 == 0) DEBUG_LOG(DEBUG_PROGRESS, "Running loop for firstEidx " + std::to_string(firstEidx) + "\r");
-    #endif
-        for (uint32_t secondEidx = firstEidx + 1; secondEidx < e.size(); secondEidx++) {
-            const EElem &firstE = e[firstEidx];
-            const EElem &secondE = e[secondEidx];
-
-            // Calculate distance
-            size_t distance = firstE.getCombination().calculateDistance(secondE.getCombination());
-
-            // Add the representation if it is a valid cm + d combination
-            assert(distance % 2 == 0 && distance >= 2 && distance <= e[0].getCombination().getNumBits());
-            if (distance == 2) {
-                assert(firstE != secondE);
-                BitRepresentation combination = firstE.getCombination() | secondE.getCombination();
-                assert(combination.countOnes() == cmPlusD);
+    minimalDistances.reset(e.size());
+
+    // Seed the minimal distances with the distances to the neighbours in locality order, which are usually close. The
+    // seed is distance + 1 with index 0, which only rules out pairs that are further apart. Every pair that could still
+    // become the minimal distance entry of an element gets checked and the result is the same as without seeding, but
+    // the prefilter below skips most pairs right from the start.
+    const size_t seedingWindow = 2;
+    std::vector<uint32_t> order = getLocalityOrder(e);
+    tbb::parallel_for(size_t(0), order.size(), [&](size_t pos) {
+        for (size_t otherPos = pos + 1; otherPos < std::min(order.size(), pos + seedingWindow + 1); otherPos++) {
+            size_t distance = e[order[pos]].getCombination().calculateDistance(e[order[otherPos]].getCombination());
+            minimalDistances.lower(order[pos], distance + 1, 0);
+            minimalDistances.lower(order[otherPos], distance + 1, 0);
+        }
+    });
 
-                SElem newS(std::move(combination), firstEidx, secondEidx, firstE.getCoveredE0Elems(), secondE.getCoveredE0Elems());
-                auto result = s.insert(newS);
-                // Merge together if this element already exists
-                if (!result.second) {
-                    result.first->getCoveredEElems().insert(newS.getCoveredEElems().begin(), newS.getCoveredEElems().end());
-                    result.first->getCoveredE0Elems().insert(newS.getCoveredE0Elems().begin(), newS.getCoveredE0Elems().end());
-                }
-            } else { // else, add to the table of minimal distances
-                // Store the mapping a --> b
-                auto pair = std::make_pair(firstEidx, std::make_pair(secondEidx, distance));
-                auto result = minimalDistances.insert(pair);
+    // Signatures of tiles of consecutive elements of e, combined with | and &. If e is ordered by locality, the
+    // elements of a tile are similar and a single bound often rules out the whole tile.
+    const size_t tileSize = 32;
+    std::vector<Signature> tileOr;
+    std::vector<Signature> tileAnd;
+    for (size_t eidx = 0; eidx < e.size(); eidx++) {
+        if (eidx % tileSize == 0) {
+            tileOr.push_back(e[eidx].getSignature());
+            tileAnd.push_back(e[eidx].getSignature());
+        } else {
+            tileOr.back() = tileOr.back() | e[eidx].getSignature();
+            tileAnd.back() = tileAnd.back() & e[eidx].getSignature();
+        }
+    }
 
-                // If adding was not successful, there is already an entry for that element of e
-                if (!result.second) {
-                    // If the currently stored minimal distance is greater than this one, replace it
-                    if (result.first->second.second > distance) {
-                        result.first->second.first = secondEidx;
-                        result.first->second.second = distance;
+    // The pair loop reads the combinations and signatures through copies of this E placed for the NUMA mode
+    EReplicas replicas(e, options.numaMode);
+
+    // Without a memory budget, all pairs form one block per rank. With one, the rows of the pair triangle are split into
+    // blocks of about the same number of pairs and S is spilled into a sorted run whenever it and the minimal distances
+    // exceed the budget after a block. Each rank runs over its own consecutive share of the blocks.
+    const size_t memoryBoundedBlocks = 64;
+    const size_t blocksPerRank = options.memoryBudget == 0 ? 1 : memoryBoundedBlocks;
+    std::vector<size_t> blockBegins = getPairBlocks(e.size(), blocksPerRank * getNumRanks());
+    size_t firstBlock = std::min(blocksPerRank * getRank(), blockBegins.size() - 1);
+    size_t endBlock = std::min(blocksPerRank * (getRank() + 1), blockBegins.size() - 1);
+    SpilledRuns spilledRuns(options.spillDirectory);
+    std::atomic<uint64_t> numDistanceTwoPairs{0};
+    bool hasDeadline = deadline != std::chrono::steady_clock::time_point::max();
+    std::atomic<bool> expired{false};
+    for (size_t block = firstBlock; block < endBlock && !expired; block++) {
+        // Run over all possible pairs in E and check if they build a possible combination
+        // The rows get shorter towards the end of the triangle, work stealing balances them
+        tbb::parallel_for(static_cast<uint32_t>(blockBegins[block]), static_cast<uint32_t>(blockBegins[block + 1]), [&](uint32_t firstEidx) {
+            // A row takes much longer than reading the clock
+            if (hasDeadline && (expired.load(std::memory_order_relaxed) || std::chrono::steady_clock::now() >= deadline)) {
+                expired.store(true, std::memory_order_relaxed);
+                return;
+            }
+        #if DEBUG >= DEBUG_VERBOSE
+            if (tbb::this_task_arena::current_thread_index() == 0) DEBUG_LOG(DEBUG_PROGRESS, "Running loop for firstEidx " + std::to_string(firstEidx) + "\r");
+        #endif
+            const EReplicas::View local = replicas.getLocal();
+            for (uint32_t secondEidx = firstEidx + 1; secondEidx < e.size(); secondEidx++) {
+
+                // At the start of a tile, skip it completely if the pair check below would skip each of its elements
+                if (secondEidx % tileSize == 0) {
+                    size_t tileIdx = secondEidx / tileSize;
+                    size_t lowerBound = local.getSignature(firstEidx).distanceLowerBound(tileOr[tileIdx], tileAnd[tileIdx]);
+                    // The other elements of the tile all have an index of at least secondEidx
+                    if (lowerBound > 2 && minimalDistances.cannotLower(firstEidx, lowerBound, secondEidx)) {
+                        size_t tileEnd = std::min(secondEidx + tileSize, e.size());
+                        size_t idx = secondEidx;
+                        while (idx < tileEnd && minimalDistances.cannotLower(idx, lowerBound, firstEidx)) {
+                            idx++;
+                        }
+                        if (idx == tileEnd) {
+                            secondEidx += tileSize - 1;
+                            continue;
+                        }
                     }
                 }
 
-                // Store the mapping b --> a
-                auto pairReverse = std::make_pair(secondEidx, std::make_pair(firstEidx, distance));
-                auto resultReverse = minimalDistances.insert(pairReverse);
+                // The signatures bound the distance from below. Skip the pair if it can neither build a valid
+                // combination nor lower the minimal distance entry of any of the two elements.
+                size_t lowerBound = local.getSignature(firstEidx).distanceLowerBound(local.getSignature(secondEidx));
+                if (lowerBound > 2
+                    && minimalDistances.cannotLower(firstEidx, lowerBound, secondEidx)
+                    && minimalDistances.cannotLower(secondEidx, lowerBound, firstEidx)) {
+                    continue;
+                }
 
-                // If adding was not successful, there is already an entry for that element of e
-                if (!resultReverse.second) {
-                    // If the currently stored minimal distance is greater than this one, replace it
-                    if (resultReverse.first->second.second > distance) {
-                        resultReverse.first->second.first = firstEidx;
-                        resultReverse.first->second.second = distance;
+                // Calculate distance
+                size_t distance = local.calculateDistance(firstEidx, secondEidx);
+
+                // Add the representation if it is a valid cm + d combination
+                assert(distance % 2 == 0 && distance >= 2 && distance <= e[0].getCombination().getNumBits());
+                if (distance == 2) {
+                    numDistanceTwoPairs.fetch_add(1, std::memory_order_relaxed);
+                    const EElem &firstE = e[firstEidx];
+                    const EElem &secondE = e[secondEidx];
+                    assert(firstE != secondE);
+                    BitRepresentation combination = firstE.getCombination() | secondE.getCombination();
+                    assert(combination.countOnes() == cmPlusD);
+
+                    SElem newS(std::move(combination), firstEidx, secondEidx, firstE.getCoveredE0Elems(), secondE.getCoveredE0Elems());
+                    auto result = s.insert(std::move(newS));
+                    // Merge together if this element already exists. newS may be gone, so merge from the pair itself.
+                    if (!result.second) {
+                        result.first->getCoveredEElems().insert({ firstEidx, secondEidx });
+                        result.first->getCoveredE0Elems().insert(firstE.getCoveredE0Elems().begin(), firstE.getCoveredE0Elems().end());
+                        result.first->getCoveredE0Elems().insert(secondE.getCoveredE0Elems().begin(), secondE.getCoveredE0Elems().end());
                     }
+                } else { // else, lower the minimal distances of both elements
+                    minimalDistances.lower(firstEidx, distance, secondEidx);
+                    minimalDistances.lower(secondEidx, distance, firstEidx);
                 }
             }
+        });
+
+        if (options.memoryBudget != 0 && getMemoryUsage(s) + minimalDistances.getMemoryUsage() > options.memoryBudget) {
+            DEBUG_LOG(DEBUG_VERBOSE, "Spilling " + std::to_string(s.size()) + " elements of S(>=2)\n");
+            spilledRuns.spill(std::vector<SElem>(std::make_move_iterator(s.begin()), std::make_move_iterator(s.end())));
+            s.clear();
         }
     }
 
+    if (hasDeadline && allreduceSum(expired ? 1 : 0) > 0) {
+        DEBUG_LOG(DEBUG_PROGRESS, "Deadline passed in generateS\n");
+        statistics.approximate = true;
+        return {};
+    }
+
+    // Always merge, so that S comes out sorted by combination no matter if and how often it was spilled
+    DEBUG_LOG(DEBUG_VERBOSE, "Merging " + std::to_string(spilledRuns.size()) + " spilled runs\n");
+    statistics.numSpilledRuns = spilledRuns.size();
+    statistics.numDistanceTwoPairs = numDistanceTwoPairs;
+    std::vector<SElem> result = spilledRuns.merge(std::vector<SElem>(std::make_move_iterator(s.begin()), std::make_move_iterator(s.end())));
+    s.clear();
+
+    // Hand S to the owners of the combinations and combine the minimal distances found by all ranks
+    if (getNumRanks() > 1) {
+        result = exchangeS(std::move(result));
+
+        std::vector<uint64_t> entries = minimalDistances.getEntries();
+        allreduceMinimum(entries);
+        minimalDistances.setEntries(entries);
+
+        statistics.numSpilledRuns = allreduceSum(statistics.numSpilledRuns);
+        statistics.numDistanceTwoPairs = allreduceSum(statistics.numDistanceTwoPairs);
+        statistics.sizeS = allreduceSum(result.size());
+    } else {
+        statistics.sizeS = result.size();
+    }
+    for (const SElem &currentS : result) {
+        statistics.bytesS += currentS.getMemoryUsage();
+    }
+    statistics.bytesS = allreduceSum(statistics.bytesS);
+    statistics.bytesMinimalDistances = minimalDistances.getMemoryUsage();
+
 #ifndef NDEBUG
     DEBUG_LOG(DEBUG_VERBOSE, "\n");
-    #pragma omp parallel for schedule(dynamic)
-    for (size_t eidx = 0; eidx < e.size(); eidx++) {
-    #if DEBUG >= DEBUG_VERBOSE && _OPENMP
-        if (omp_get_thread_num() == 0) DEBUG_LOG(DEBUG_VERBOSE, "Fitting element " + std::to_string(eidx + 1) + "\r");
-    #elif DEBUG >= DEBUG_VERBOSE
-        if (eidx % 10 == 0) DEBUG_LOG(DEBUG_VERBOSE, "Fitting element " + std::to_string(eidx + 1) + "\r");
+    tbb::parallel_for(size_t(0), e.size(), [&](size_t eidx) {
+    #if DEBUG >= DEBUG_VERBOSE
+        if (tbb::this_task_arena::current_thread_index() == 0) DEBUG_LOG(DEBUG_VERBOSE, "Fitting element " + std::to_string(eidx + 1) + "\r");
     #endif
         const EElem &currentE = e[eidx];
-        for (const SElem &currentS : s) {
+        for (const SElem &currentS : result) {
             if (currentS.covers(currentE.getCombination())) {
                 if (!currentS.getCoveredEElems().count(eidx)) {
                     assert(false && "There was an uncovered element that is covered by a created combination, this should never happen.");
                 }
             }
         }
-    }
+    });
 #endif
 
     DEBUG_LOG(DEBUG_VERBOSE, "\n");
-    DEBUG_LOG(DEBUG_PROGRESS, "Size S(>=2): " + std::to_string(s.size()) + "\n");
-    return std::vector<SElem>(std::make_move_iterator(s.begin()), std::make_move_iterator(s.end()));
+    DEBUG_LOG(DEBUG_PROGRESS, "Size S(>=2): " + std::to_string(result.size()) + "\n");
+    return result;
+}
+
+/**
+ * Cheap replacement for generateS when the time budget runs out. Only pairs up to a few positions apart in locality
+ * order are checked, so it takes linear instead of quadratic time but misses combinations of elements that are not
+ * neighbours. The minimal distances hold a real partner for every element, so findMinimalSubset can fill up any
+ * element it did not cover, also when it stops early. Each rank computes the whole set.
+ *
+ * @param cmPlusD The number of elements in a combination.
+ * @param e The set E as described in generateE.
+ * @param minimalDistances Gets the minimal distance of each element of e among the checked pairs.
+ * @param statistics Gets the size of S and the number of distance 2 pairs.
+ * @return The set S of the checked pairs, sorted by combination.
+ */
+std::vector<SElem> generateSApproximate(size_t cmPlusD, const std::vector<EElem> &e, MinimalDistances &minimalDistances, RoundStatistics &statistics) {
+    assert(!e.empty());
+    ScopedPhase phase("generateSApproximate");
+
+    tbb::concurrent_unordered_set<SElem, std::hash<SElem>> s;
+    minimalDistances.reset(e.size());
+
+    const size_t window = 8;
+    std::vector<uint32_t> order = getLocalityOrder(e);
+    std::atomic<uint64_t> numDistanceTwoPairs{0};
+    tbb::parallel_for(size_t(0), order.size(), [&](size_t pos) {
+        for (size_t otherPos = pos + 1; otherPos < std::min(order.size(), pos + window + 1); otherPos++) {
+            uint32_t firstEidx = std::min(order[pos], order[otherPos]);
+            uint32_t secondEidx = std::max(order[pos], order[otherPos]);
+            const EElem &firstE = e[firstEidx];
+            const EElem &secondE = e[secondEidx];
+            size_t distance = firstE.getCombination().calculateDistance(secondE.getCombination());
+            minimalDistances.lower(firstEidx, distance, secondEidx);
+            minimalDistances.lower(secondEidx, distance, firstEidx);
+            if (distance == 2) {
+                numDistanceTwoPairs.fetch_add(1, std::memory_order_relaxed);
+                BitRepresentation combination = firstE.getCombination() | secondE.getCombination();
+                assert(combination.countOnes() == cmPlusD);
+
+                SElem newS(std::move(combination), firstEidx, secondEidx, firstE.getCoveredE0Elems(), secondE.getCoveredE0Elems());
+                auto result = s.insert(std::move(newS));
+                if (!result.second) {
+                    result.first->getCoveredEElems().insert({ firstEidx, secondEidx });
+                    result.first->getCoveredE0Elems().insert(firstE.getCoveredE0Elems().begin(), firstE.getCoveredE0Elems().end());
+                    result.first->getCoveredE0Elems().insert(secondE.getCoveredE0Elems().begin(), secondE.getCoveredE0Elems().end());
+                }
+            }
+        }
+    });
+
+    std::vector<SElem> result(std::make_move_iterator(s.begin()), std::make_move_iterator(s.end()));
+    std::sort(result.begin(), result.end(), [](const SElem &lhs, const SElem &rhs) {
+        return lhs.getCombination() < rhs.getCombination();
+    });
+    statistics.numDistanceTwoPairs = numDistanceTwoPairs;
+    statistics.sizeS = result.size();
+    statistics.bytesMinimalDistances = minimalDistances.getMemoryUsage();
+    DEBUG_LOG(DEBUG_PROGRESS, "Size approximate S(>=2): " + std::to_string(result.size()) + "\n");
+    return result;
+}
+
+/**
+ * The order in which findMinimalSubset runs over S. Of two elements with equally long diffsets, it picks the first.
+ */
+static bool comesFirst(const SElem &lhs, const SElem &rhs) {
+#ifdef DETERMINISM
+    return lhs < rhs;
+#else
+    return lhs.getCombination() < rhs.getCombination();
+#endif
 }
 
 /**
  * Finds the minimal subset of the set S that is covering all of the set E.
  *
  * @param e The set E to cover.
- * @param s The set S as input.
+ * @param s The set S as input, or the part of it owned by this rank.
+ * @param minimalDistances The minimal distances of the generateS or generateSApproximate that created s.
+ * @param statistics Gets the number of fill-up elements.
+ * @param deadline When to stop picking elements of S and fill up the rest. Only for S of generateSApproximate, the
+ * minimal distances of generateS do not have a partner for every element.
  * @return The found minimal subset.
  */
-std::vector<EElem> findMinimalSubset(const std::vector<EElem> &e, std::vector<SElem> &&s) {
+std::vector<EElem> findMinimalSubset(const std::vector<EElem> &e, std::vector<SElem> &&s, const MinimalDistances &minimalDistances,
+                                     RoundStatistics &statistics, std::chrono::steady_clock::time_point deadline) {
+    ScopedPhase phase("findMinimalSubset");
     DEBUG_LOG(DEBUG_PROGRESS, "Searching for minimal subset S*... ");
 
-    std::set<size_t> alreadyCovered;
+    // Flags for the elements of e, counting them separately avoids a set with one node per covered element
+    std::vector<bool> alreadyCovered(e.size(), false);
+    size_t numAlreadyCovered = 0;
     std::set<size_t> alreadyCoveredE0;
-    tbb::concurrent_vector<EElem> minimalSubset;
+    std::vector<EElem> minimalSubset;
     minimalSubset.reserve(e.size());
 
     // Only for determinism. Not actually needed.
@@ -255,34 +534,74 @@ std::vector<EElem> findMinimalSubset(const std::vector<EElem> &e, std::vector<SE
     DEBUG_LOG(DEBUG_VERBOSE, "\nS(>=2) covers " + std::to_string(uniques.size()) + " unique elements of e\n");
 #endif
 
-    // As long as not all of e is covered, i.e. alreadyCovered and E differ
-    // Because of how the loop works (adding diffsets), alreadyCovered and E are the same when they have the same number of elements
-    while (alreadyCovered.size() != e.size()) {
-        // findest longest difference set
-        std::set<size_t> longestDiffset;
+    bool hasDeadline = deadline != std::chrono::steady_clock::time_point::max();
+
+    // As long as not all of e is covered
+    while (numAlreadyCovered != e.size()) {
+        // All ranks have to stop in the same iteration, as each one exchanges the candidates
+        if (hasDeadline && allreduceSum(std::chrono::steady_clock::now() >= deadline ? 1 : 0) > 0) {
+            DEBUG_LOG(DEBUG_PROGRESS, "Deadline passed in findMinimalSubset\n");
+            break;
+        }
+
+        // findest longest difference set, only its size is needed to pick it
+        size_t longestDiffsetSize = 0;
         size_t longestDiffsetSElemIdx = 0;
         for (size_t i = 0; i < s.size(); i++) {
-            SElem &currentS = s[i];
-            std::set<size_t> diff;
-            boost::range::set_difference(currentS.getCoveredEElems(), alreadyCovered, std::inserter(diff, diff.end()));
-            if (diff.size() > longestDiffset.size()) {
-                longestDiffset = diff;
+            size_t diffSize = 0;
+            for (uint32_t eidx : s[i].getCoveredEElems()) {
+                diffSize += !alreadyCovered[eidx];
+            }
+            if (diffSize > longestDiffsetSize) {
+                longestDiffsetSize = diffSize;
                 longestDiffsetSElemIdx = i;
             }
         }
 
-        // If there is no longest diffset, we need to fill with combinations that cover only one element of E
-        if (longestDiffset.empty()) {
-            break;
+        SElem sElemOfLongestDiffset;
+        if (getNumRanks() > 1) {
+            // Each rank owns a part of S. Pick the best of their candidates the way the loop above would have.
+            std::vector<std::pair<int, SElem>> candidates = allgatherCandidates(longestDiffsetSize == 0 ? nullptr : &s[longestDiffsetSElemIdx]);
+            size_t best = candidates.size();
+            longestDiffsetSize = 0;
+            for (size_t i = 0; i < candidates.size(); i++) {
+                size_t diffSize = 0;
+                for (uint32_t eidx : candidates[i].second.getCoveredEElems()) {
+                    diffSize += !alreadyCovered[eidx];
+                }
+                if (diffSize > longestDiffsetSize
+                    || (diffSize == longestDiffsetSize && diffSize > 0 && comesFirst(candidates[i].second, candidates[best].second))) {
+                    longestDiffsetSize = diffSize;
+                    best = i;
+                }
+            }
+
+            // If there is no longest diffset, we need to fill with combinations that cover only one element of E
+            if (longestDiffsetSize == 0) {
+                break;
+            }
+            sElemOfLongestDiffset = std::move(candidates[best].second);
+            if (candidates[best].first == getRank()) {
+                s.erase(s.begin() + longestDiffsetSElemIdx);
+            }
+        } else {
+            // If there is no longest diffset, we need to fill with combinations that cover only one element of E
+            if (longestDiffsetSize == 0) {
+                break;
+            }
+            sElemOfLongestDiffset = std::move(s[longestDiffsetSElemIdx]);
+            s.erase(s.begin() + longestDiffsetSElemIdx);
         }
-        SElem &sElemOfLongestDiffset = s[longestDiffsetSElemIdx];
 
         // Add all elements of the found longest diffset to the already covered elements of e
-        alreadyCovered.insert(longestDiffset.begin(), longestDiffset.end());
+        for (uint32_t eidx : sElemOfLongestDiffset.getCoveredEElems()) {
+            alreadyCovered[eidx] = true;
+        }
+        numAlreadyCovered += longestDiffsetSize;
 
         // add found longest diffset combination to the resulting minimal subset
         // skip original e elements that are already covered by other mininmal subset elements
-        std::set<uint32_t> allCoveredE0 = sElemOfLongestDiffset.getCoveredE0Elems();
+        std::set<uint32_t> allCoveredE0 = std::move(sElemOfLongestDiffset.getCoveredE0Elems());
         sElemOfLongestDiffset.getCoveredE0Elems().clear();
 
         boost::set_difference(allCoveredE0, alreadyCoveredE0,
@@ -291,46 +610,42 @@ std::vector<EElem> findMinimalSubset(const std::vector<EElem> &e, std::vector<SE
         // Add all newly covered original e elements in the already covered original e elements
         alreadyCoveredE0.insert(sElemOfLongestDiffset.getCoveredE0Elems().begin(), sElemOfLongestDiffset.getCoveredE0Elems().end());
 
-        // Push to longest subset and remove from s
+        // Push to longest subset, it was already removed from s
         minimalSubset.push_back(EElem(std::move(sElemOfLongestDiffset)));
-        s.erase(s.begin() + longestDiffsetSElemIdx);
     }
 
-    int counter = 0;
-    DEBUG_LOG(DEBUG_VERBOSE, "Elements not covered yet: " + std::to_string(e.size() - alreadyCovered.size()) + "\n");
+    DEBUG_LOG(DEBUG_VERBOSE, "Elements not covered yet: " + std::to_string(e.size() - numAlreadyCovered) + "\n");
+    statistics.numFillUps = e.size() - numAlreadyCovered;
 
-    // Fill up coverage if needed
-    if (alreadyCovered.size() != e.size()) {
-        // Convert alreadyCovered to concurrent set
-        tbb::concurrent_unordered_set<size_t> alreadyCoveredConcurrent(
-                std::make_move_iterator(alreadyCovered.begin()), std::make_move_iterator(alreadyCovered.end()));
-
-        #pragma omp parallel for schedule(dynamic)
-        for (size_t eidx = 0; eidx < e.size(); eidx++) {
-        #if DEBUG >= DEBUG_VERBOSE && _OPENMP
-            if (omp_get_thread_num() == 0) DEBUG_LOG(DEBUG_VERBOSE, "Filling element " + std::to_string(eidx) + "\r");
-        #elif DEBUG >= DEBUG_VERBOSE
-            if (eidx % 10 == 0) DEBUG_LOG(DEBUG_VERBOSE, "Filling element " + std::to_string(eidx) + "\r");
+    // Fill up coverage if needed. Each element of e gets its own slot, so the fill-up elements are appended in the order
+    // of e however the threads ran, and all ranks end up with the same S*.
+    if (numAlreadyCovered != e.size()) {
+        std::vector<std::unique_ptr<EElem>> fillUps(e.size());
+        tbb::parallel_for(size_t(0), e.size(), [&](size_t eidx) {
+        #if DEBUG >= DEBUG_VERBOSE
+            if (tbb::this_task_arena::current_thread_index() == 0) DEBUG_LOG(DEBUG_VERBOSE, "Filling element " + std::to_string(eidx) + "\r");
         #endif
 
             // If the element of e is not already covered, generate a coverage element for it
-            if (!alreadyCoveredConcurrent.count(eidx)) {
-                counter++;
-                // Get the minimalDistances entry for this element of e
-                auto elementIterator = minimalDistances.find(eidx);
-                assert(elementIterator != minimalDistances.end());
-                assert(elementIterator->second.second > 2);
+            if (!alreadyCovered[eidx]) {
+                // The element of e with the minimal distance to this one
+                uint32_t otherEidx = minimalDistances.getIndex(eidx);
+                assert(otherEidx < e.size());
+                assert(minimalDistances.getDistance(eidx) > 2 || statistics.approximate);
 
                 BitRepresentation combination = e[eidx].getCombination();
-                const BitRepresentation &otherElement = e[elementIterator->second.first].getCombination();
+                const BitRepresentation &otherElement = e[otherEidx].getCombination();
 
                 // Flip a bit that makes the combination approach towards the element that is closest to the combination
                 // by flipping a bit to 1 that is already a one in the other element
-                BitRepresentation copy = combination;
                 combination.setRightmost(otherElement);
 
-                // Insert the covering element
-                minimalSubset.push_back(EElem(std::move(combination), e[eidx].getCoveredE0Elems()));
+                fillUps[eidx].reset(new EElem(std::move(combination), e[eidx].getCoveredE0Elems()));
+            }
+        });
+        for (std::unique_ptr<EElem> &fillUp : fillUps) {
+            if (fillUp) {
+                minimalSubset.push_back(std::move(*fillUp));
             }
         }
     }
@@ -348,7 +663,7 @@ std::vector<EElem> findMinimalSubset(const std::vector<EElem> &e, std::vector<SE
     DEBUG_LOG(DEBUG_VERBOSE, "\n");
     DEBUG_LOG(DEBUG_PROGRESS, "Size S*: " + std::to_string(minimalSubset.size()) + "\n");
 
-    return std::vector<EElem>(std::make_move_iterator(minimalSubset.begin()), std::make_move_iterator(minimalSubset.end()));
+    return minimalSubset;
 }
 
 /**
@@ -356,11 +671,37 @@ std::vector<EElem> findMinimalSubset(const std::vector<EElem> &e, std::vector<SE
  *
  * @param t cmPlusD The number of elements per combination in T.
  * @param e The set E as described in generateE.
- * @return The found minimal set. The size of the minimal set is the value k.
+ * @param options The options of the run.
+ * @param minimalDistances Holds the minimal distances of this round, reused from round to round.
+ * @param statistics Gets the statistics of both phases and their times, and whether the round was approximate.
+ * @param deadline If generateS does not make it until then, the round is given up.
+ * @param approximate Use generateSApproximate right away.
+ * @return The found minimal set. The size of the minimal set is the value k. Empty if the round was given up, as an
+ * approximate round after the deadline would only fill up all of E.
  */
-std::vector<EElem> minimumKAndD(size_t cmPlusD, const std::vector<EElem> &e) {
+std::vector<EElem> minimumKAndD(size_t cmPlusD, const std::vector<EElem> &e, const PartitionOptions &options, MinimalDistances &minimalDistances,
+                                RoundStatistics &statistics, std::chrono::steady_clock::time_point deadline, bool approximate) {
     DEBUG_LOG(DEBUG_PROGRESS, "Running minKD\n");
-    return findMinimalSubset(e, generateS(cmPlusD, e));
+    auto start = std::chrono::steady_clock::now();
+    std::vector<SElem> s;
+    if (approximate) {
+        statistics.approximate = true;
+        s = generateSApproximate(cmPlusD, e, minimalDistances, statistics);
+    } else {
+        s = generateS(cmPlusD, e, options, minimalDistances, statistics, deadline);
+        if (statistics.approximate) {
+            return {};
+        }
+    }
+    auto generated = std::chrono::steady_clock::now();
+    std::vector<EElem> sStar = statistics.approximate
+                               ? findMinimalSubset(e, std::move(s), minimalDistances, statistics, deadline)
+                               : findMinimalSubset(e, std::move(s), minimalDistances, statistics);
+    auto end = std::chrono::steady_clock::now();
+
+    statistics.generateSNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(generated - start).count();
+    statistics.findMinimalSubsetNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(end - generated).count();
+    return sStar;
 }
 
 /**
@@ -371,64 +712,239 @@ std::vector<EElem> minimumKAndD(size_t cmPlusD, const std::vector<EElem> &e) {
  * @return the set E without duplicates
  */
 std::vector<EElem> generateE(const Hypergraph &hypergraph) {
+    ScopedPhase phase("generateE");
     DEBUG_LOG(DEBUG_PROGRESS, "Generating E... ");
     DEBUG_LOG(DEBUG_VERBOSE, "\n");
     const std::vector<uint32_t> &hypernodes = hypergraph.getHypernodes();
-    std::vector<hElem> hyperedges = hypergraph.getHyperEdges();
-    std::reverse(hyperedges.begin(), hyperedges.end());
+    // The bits of the combinations hold the hyperedges in reverse order
+    const std::vector<hElem> &hyperedges = hypergraph.getHyperEdges();
 
     // Set covered e element for each entry
     std::vector<EElem> e(hypernodes.size(), EElem(hyperedges.size()));
-    for (uint32_t i = 0; i < e.size(); i++) {
-        e[i].getCoveredE0Elems().insert(i);
-    }
-
-    // Set all combinations accordingly
-    for (size_t hyperedgeIdx = 0; hyperedgeIdx < hyperedges.size(); hyperedgeIdx++) {
-        DEBUG_LOG(DEBUG_VERBOSE, "Generating entry for hyperedge ID " + std::to_string(hyperedgeIdx) + "\r");
-        for (uint32_t node : hyperedges[hyperedgeIdx]) {
-            e[node].getCombination().setBit(hyperedgeIdx);
+    tbb::parallel_for(size_t(0), e.size(), [&](size_t i) {
+        e[i].getCoveredE0Elems().insert(static_cast<uint32_t>(i));
+    });
+
+    // Set all combinations accordingly. Each task sets the bits of one cache line of words, so no two tasks write to
+    // the same word of a combination.
+    const size_t bitsPerTask = 8 * 64;
+    tbb::parallel_for(size_t(0), (hyperedges.size() + bitsPerTask - 1) / bitsPerTask, [&](size_t task) {
+        size_t end = std::min(hyperedges.size(), (task + 1) * bitsPerTask);
+        for (size_t bit = task * bitsPerTask; bit < end; bit++) {
+            for (uint32_t node : hyperedges[hyperedges.size() - 1 - bit]) {
+                e[node].getCombination().setBit(bit);
+            }
         }
-    }
-    DEBUG_LOG(DEBUG_VERBOSE, "\nDone.\n");
+    });
 
-#if DEBUG > 0
-    size_t entryIdx = 0;
-#endif
+    // The combinations were modified in place, refresh the cached hashes and signatures
+    tbb::parallel_for(size_t(0), e.size(), [&](size_t i) {
+        e[i].updateHash();
+        e[i].updateSignature();
+    });
+    DEBUG_LOG(DEBUG_VERBOSE, "Done.\n");
 
+    // Sort the entries by combination and keep the first of each run of equal ones, which gets the covered elements
+    // of the others. The result is ordered like a std::set of the entries.
     DEBUG_LOG(DEBUG_VERBOSE, "Removing Duplicates...\n");
-    std::set<EElem> tempSet;
-    for (auto &entry : e) {
-        DEBUG_LOG(DEBUG_VERBOSE, "Checking entry ID " + std::to_string(entryIdx++) + "\r");
-        // Move is fine here because entry is only used again if the insert failed --> no move happened
-        auto result = tempSet.insert(std::move(entry));
-        if (!result.second) {
-            result.first->getCoveredE0Elems().insert(entry.getCoveredE0Elems().begin(), entry.getCoveredE0Elems().end());
+    std::vector<uint32_t> order(e.size());
+    for (uint32_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    tbb::parallel_sort(order.begin(), order.end(), [&e](uint32_t lhs, uint32_t rhs) {
+        return e[lhs] < e[rhs] || (!(e[rhs] < e[lhs]) && lhs < rhs);
+    });
+    std::vector<char> startsRun(order.size());
+    tbb::parallel_for(size_t(0), order.size(), [&](size_t pos) {
+        startsRun[pos] = pos == 0 || e[order[pos - 1]] < e[order[pos]];
+    });
+    std::vector<size_t> runBegins;
+    for (size_t pos = 0; pos < order.size(); pos++) {
+        if (startsRun[pos]) {
+            runBegins.push_back(pos);
         }
     }
-    std::vector<EElem> noDuplicates(std::make_move_iterator(tempSet.begin()), std::make_move_iterator(tempSet.end()));
-    DEBUG_LOG(DEBUG_VERBOSE, "\nDone.\n");
+    runBegins.push_back(order.size());
+
+    std::vector<EElem> noDuplicates;
+    noDuplicates.reserve(runBegins.size() - 1);
+    for (size_t run = 0; run + 1 < runBegins.size(); run++) {
+        noDuplicates.push_back(std::move(e[order[runBegins[run]]]));
+    }
+    tbb::parallel_for(size_t(0), noDuplicates.size(), [&](size_t run) {
+        std::set<uint32_t> &covered = noDuplicates[run].getCoveredE0Elems();
+        for (size_t pos = runBegins[run] + 1; pos < runBegins[run + 1]; pos++) {
+            covered.insert(static_cast<uint32_t>(order[pos]));
+        }
+    });
+    DEBUG_LOG(DEBUG_VERBOSE, "Done.\n");
 
     DEBUG_LOG(DEBUG_PROGRESS, "Size E: " + std::to_string(e.size()) + ", Size E(nodups): " + std::to_string(noDuplicates.size()) + "\n");
     return noDuplicates;
 }
 
 /**
- * Partitions the input hypergraph.
+ * Numbers the blocks of a partitioning in the order of the partitions, sorted first if the output is deterministic.
+ */
+static SitePartitioning numberBlocks(const Hypergraph &hypergraph, size_t k, std::vector<std::vector<size_t>> partitions) {
+#ifdef DETERMINISM
+    std::sort(partitions.begin(), partitions.end());
+#endif
+
+    SitePartitioning result;
+    result.k = k;
+    result.blockOfSite.resize(hypergraph.getHypernodes().size());
+    for (uint32_t block = 0; block < partitions.size(); block++) {
+        for (size_t site : partitions[block]) {
+            result.blockOfSite[site] = block;
+        }
+    }
+    return result;
+}
+
+/**
+ * Extracts the partitioning for k from the set S* of a round.
  *
- * @param n number of CPUs (argument 'k' of the program call).
- * @param hypergraph the hypergraph to partition.
- * @return The resulting partitions as set of hypernode sets.
+ * @param hypergraph The partitioned hypergraph.
+ * @param sStar The set S* of the round, each element is one block.
+ * @param k The number of blocks, filled up with empty ones if S* is smaller.
  */
-void partition(const Hypergraph &hypergraph, const std::set<size_t> &setOfKs) {
+static SitePartitioning extractPartitioning(const Hypergraph &hypergraph, const std::vector<EElem> &sStar, size_t k) {
+    ScopedPhase phase("extractPartitions");
+    std::vector<std::vector<size_t>> partitions;
+
+    for (const EElem &currentSStarElem : sStar) {
+        // Convert covered elements to partition
+        std::vector<size_t> partition(currentSStarElem.getCoveredE0Elems().begin(), currentSStarElem.getCoveredE0Elems().end());
+
+    #ifndef NDEBUG
+        if (partition.empty()) {
+            std::cerr << "A partition element wasn't used for partitioning at all: " << currentSStarElem.getCombination() << std::endl;
+            assert(!partition.empty());
+        }
+    #endif
+
+        partitions.push_back(std::move(partition));
+    }
+
+    // If there are no elements in sStar left but there are not enough partitions yet, fill with empties
+    if (partitions.size() < k) {
+        for (size_t i = partitions.size(); i < k; i++) {
+            partitions.emplace_back();
+        }
+    }
+
+    assert(partitionsContainAllVertices(hypergraph, partitions));
+
+    return numberBlocks(hypergraph, k, std::move(partitions));
+}
+
+/**
+ * Merges the blocks of S* into k blocks when the time budget ran out before a round reached k. Blocks close in locality
+ * order share most of their hyperedges, so each of the k blocks takes a contiguous range of that order, all ranges with
+ * about the same number of blocks of S*.
+ *
+ * @param sStar The S* of the last round, with more than k elements.
+ * @param order The indices of sStar in locality order, see getLocalityOrder. The same for all ks.
+ */
+static SitePartitioning fallbackPartitioning(const Hypergraph &hypergraph, const std::vector<EElem> &sStar, const std::vector<uint32_t> &order, size_t k) {
+    ScopedPhase phase("fallbackMerge");
+    std::vector<std::vector<size_t>> partitions(k);
+    for (size_t position = 0; position < order.size(); position++) {
+        const std::set<uint32_t> &sites = sStar[order[position]].getCoveredE0Elems();
+        std::vector<size_t> &partition = partitions[position * k / order.size()];
+        partition.insert(partition.end(), sites.begin(), sites.end());
+    }
+    for (std::vector<size_t> &partition : partitions) {
+        std::sort(partition.begin(), partition.end());
+    }
+
+    assert(partitionsContainAllVertices(hypergraph, partitions));
+
+    SitePartitioning result = numberBlocks(hypergraph, k, std::move(partitions));
+    result.exact = false;
+    return result;
+}
+
+/**
+ * Hands out the partitionings for all ks of listOfKs that the rounds of a state already reached, largest k first, and
+ * removes them from listOfKs. They are extracted from the recorded blocks, so they are the same as in the run that
+ * recorded them.
+ */
+static void extractFromState(const Hypergraph &hypergraph, const PartitionState &state, std::vector<size_t> &listOfKs, const PartitioningConsumer &consumer) {
+    MergeHierarchy hierarchy = state.recorder.finish();
+    size_t lastK = hierarchy.getK(hierarchy.getNumRounds() - 1);
+    while (!listOfKs.empty() && listOfKs.back() >= lastK) {
+        SitePartitioning partitioning;
+        {
+            ScopedPhase phase("extractPartitions");
+            hierarchy.extract(listOfKs.back(), partitioning);
+            partitioning = numberBlocks(hypergraph, partitioning.k, partitioning.getBlocks());
+            partitioning.exact = state.exact;
+        }
+        consumer(partitioning);
+        listOfKs.pop_back();
+    }
+}
+
+/**
+ * Partitions the input hypergraph. Must be called inside a task arena, all parallel loops of the rounds share its
+ * threads. JudiciousPartitioner sets that up.
+ *
+ * @param hypergraph The hypergraph to partition.
+ * @param setOfKs The numbers of CPUs to partition for.
+ * @param options The options of the run.
+ * @param consumer Receives the partitioning for each k, largest k first. With a time budget, the partitionings after
+ *                 the first approximate round are marked as not exact.
+ * @param state If not null, the rounds continue from it and it gets the state after the last round. The ks its rounds
+ *              reached come from its recorded blocks without running any round.
+ */
+void partition(const Hypergraph &hypergraph, const std::set<size_t> &setOfKs, const PartitionOptions &options, const PartitioningConsumer &consumer, PartitionState *state) {
     DEBUG_LOG(DEBUG_PROGRESS, "Hyperedges: " + std::to_string(hypergraph.getHyperEdges().size()) + " Hypernodes: " + std::to_string(hypergraph.getHypernodes().size()) + "\n");
 
-    // Generate set E according to the paper
-    std::vector<EElem> e = generateE(hypergraph);
+    std::vector<size_t> listOfKs(setOfKs.begin(), setOfKs.end());
+    // The blocks of the rounds are only recorded if someone reads them later
+    bool checkpointing = !options.checkpointPath.empty() && getRank() == 0;
+    bool recording = state != nullptr || checkpointing;
+    PartitionState localState;
+    if (state == nullptr) {
+        state = &localState;
+    }
+    // E lives in the state, so the state is complete after each round
+    std::vector<EElem> &e = state->e;
+    size_t firstD = 1;
+    if (state->d > 0) {
+        extractFromState(hypergraph, *state, listOfKs, consumer);
+        if (listOfKs.empty()) {
+            return;
+        }
+        firstD = state->d + 1;
+    } else {
+        // Generate set E according to the paper
+        e = generateE(hypergraph);
+        if (recording) {
+            state->recorder = MergeHierarchy::Recorder(e, hypergraph.getHypernodes().size());
+        }
+    }
+    uint64_t checkpointKey = checkpointing ? ResultCache::getKey(hypergraph, options.localityReordering) : 0;
+    auto lastCheckpoint = std::chrono::steady_clock::now();
+
+    // The time budget counts from options.timeBudgetStart, or from here if it is not set. The pair loop of generateS is
+    // quadratic in |E|, so the time per pair of the last exact round predicts whether the next one still fits.
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    if (options.timeBudget > 0) {
+        std::chrono::steady_clock::time_point start = options.timeBudgetStart;
+        if (start == std::chrono::steady_clock::time_point()) {
+            start = std::chrono::steady_clock::now();
+        }
+        deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(options.timeBudget));
+    }
+    double nanosecondsPerPair = 0;
+    bool outOfTime = false;
 
     // calulate hyperdegree of the hypergraph
-    // We assume that all hypernodes have the same degree
-    size_t cm = e[0].countOnes();
+    // We assume that all hypernodes have the same degree. The elements of E after round d cover cm + d hyperedges.
+    size_t cm = e[0].countOnes() - (firstD - 1);
 
 #ifndef NDEBUG
     for (const EElem &curE : e) {
@@ -441,12 +957,64 @@ void partition(const Hypergraph &hypergraph, const std::set<size_t> &setOfKs) {
 
     DEBUG_LOG(DEBUG_PROGRESS, "Hyperdegree: " + std::to_string(cm) + "\n");
 
-    std::vector<size_t> listOfKs(setOfKs.begin(), setOfKs.end());
     std::vector<EElem> sStar;
+    MinimalDistances minimalDistances;
+    // Hands the partitionings found in a round to the consumer while the next round runs. It only reads e, which the
+    // next round does too.
+    tbb::task_group output;
+    std::unique_ptr<TelemetryWriter> telemetry;
+    if (!options.telemetryPath.empty() && getRank() == 0) {
+        telemetry.reset(new TelemetryWriter(options.telemetryPath));
+    }
     // Can skip the first cycle because that results in E = S* anyway
-    for (size_t d = 1; d < m - cm; d++) {
+    for (size_t d = firstD; d < m - cm; d++) {
+        auto roundStart = std::chrono::steady_clock::now();
+        bool approximate = !state->exact;
+        if (options.timeBudget > 0) {
+            // All ranks have to take the same decision
+            double numPairs = 0.5 * e.size() * e.size();
+            auto predictedEnd = roundStart + std::chrono::nanoseconds(static_cast<int64_t>(nanosecondsPerPair * numPairs));
+            outOfTime = allreduceSum(roundStart >= deadline ? 1 : 0) > 0;
+            approximate |= allreduceSum(predictedEnd >= deadline ? 1 : 0) > 0;
+            if (outOfTime) {
+                break;
+            }
+        }
+        ScopedPhase round("Round " + std::to_string(d));
         DEBUG_LOG(DEBUG_PROGRESS, "Running with cm+d " + std::to_string(cm + d) + "\n");
-        sStar = minimumKAndD(cm + d, e);
+        if (options.localityReordering) {
+            // Reordering writes to e, so the output of the previous round has to be done
+            output.wait();
+            reorderForLocality(e);
+        }
+        RoundStatistics statistics;
+        statistics.d = d;
+        statistics.cmPlusD = cm + d;
+        statistics.sizeE = e.size();
+        for (const EElem &currentE : e) {
+            statistics.bytesE += currentE.getMemoryUsage();
+            statistics.bytesCoveredE0Elems += currentE.getCoveredE0MemoryUsage();
+        }
+        int peakSlot = MemoryAccounting::beginPeak();
+        uint64_t startAllocations = MemoryAccounting::getNumAllocations();
+        sStar = minimumKAndD(cm + d, e, options, minimalDistances, statistics, deadline, approximate);
+        statistics.peakLiveBytes = MemoryAccounting::endPeak(peakSlot);
+        statistics.numAllocations = MemoryAccounting::getNumAllocations() - startAllocations;
+        if (sStar.empty()) {
+            // The deadline passed in generateS, the fallback merge takes E of the previous round
+            outOfTime = true;
+            break;
+        }
+        if (statistics.approximate) {
+            state->exact = false;
+        } else {
+            nanosecondsPerPair = (statistics.generateSNanoseconds + statistics.findMinimalSubsetNanoseconds) / std::max(1.0, 0.5 * e.size() * e.size());
+        }
+        statistics.sizeSStar = sStar.size();
+        if (recording) {
+            state->recorder.addRound(sStar);
+        }
+        state->d = d;
 
     #ifndef NDEBUG
         size_t numberOfOnes = sStar[0].countOnes();
@@ -455,58 +1023,67 @@ void partition(const Hypergraph &hypergraph, const std::set<size_t> &setOfKs) {
         }
     #endif
 
+        // Replace e with sStar once the output of the previous round is done with it
         size_t k = sStar.size();
-        if (!listOfKs.empty()) {
-            // Replace e with sStar
-            e = std::move(sStar);
-        } else {
-            return;
-        }
-
-        size_t element;
-        element = listOfKs.back();
-        while (element >= k) {
-            // Extract partitions
-            std::vector<std::vector<size_t>> partitions;
-
-            for (const EElem &currentSStarElem : e) {
-                // Convert covered elements to partition
-                std::vector<size_t> partition(currentSStarElem.getCoveredE0Elems().begin(), currentSStarElem.getCoveredE0Elems().end());
-
-            #ifndef NDEBUG
-                if (partition.empty()) {
-                    std::cerr << "A partition element wasn't used for partitioning at all: " << currentSStarElem.getCombination() << std::endl;
-                    assert(!partition.empty());
-                }
-            #endif
-
-                partitions.push_back(std::move(partition));
+        output.wait();
+        e = std::move(sStar);
+
+        // The ks of this round are not written yet, so they stay in the checkpoint
+        auto now = std::chrono::steady_clock::now();
+        if (checkpointing && now - lastCheckpoint >= std::chrono::seconds(options.checkpointInterval)) {
+            ScopedPhase phase("checkpoint");
+            if (!writeCheckpoint(options.checkpointPath, checkpointKey, listOfKs, *state)) {
+                std::cerr << "Could not write the checkpoint " << options.checkpointPath << std::endl;
             }
+            lastCheckpoint = now;
+        }
 
-            // If there are no elements in sStar left but there are not enough partitions yet, fill with empties
-            if (partitions.size() < element) {
-                for (size_t i = partitions.size(); i < element; i++) {
-                    partitions.emplace_back();
+        // Take all ks this round reaches, largest first as they are handed out
+        std::vector<size_t> reachedKs;
+        while (!listOfKs.empty() && listOfKs.back() >= k) {
+            reachedKs.push_back(listOfKs.back());
+            listOfKs.pop_back();
+        }
+        if (!reachedKs.empty()) {
+            bool exact = state->exact;
+            output.run([&hypergraph, &e, &consumer, reachedKs, exact] {
+                DetachedPhases detached;
+                for (size_t reachedK : reachedKs) {
+                    SitePartitioning partitioning = extractPartitioning(hypergraph, e, reachedK);
+                    partitioning.exact = exact;
+                    consumer(partitioning);
                 }
-            }
-
-            assert(partitionsContainAllVertices(hypergraph, partitions));
+            });
+        }
 
-        #ifdef DETERMINISM
-            std::sort(partitions.begin(), partitions.end());
-        #endif
+        if (telemetry) {
+            statistics.ks = std::move(reachedKs);
+            statistics.roundNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - roundStart).count();
+            statistics.peakResidentBytes = TelemetryWriter::getPeakResidentBytes();
+            telemetry->write(statistics);
+        }
 
-            printDDF(element, partitions);
+        // All partitionings found, exiting
+        if (listOfKs.empty()) {
+            break;
+        }
+    }
+    output.wait();
+    if (outOfTime) {
+        DEBUG_LOG(DEBUG_PROGRESS, "Out of time, merging S* for the remaining ks\n");
+        std::vector<uint32_t> order = getLocalityOrder(e);
+        while (!listOfKs.empty()) {
+            consumer(fallbackPartitioning(hypergraph, e, order, listOfKs.back()));
             listOfKs.pop_back();
-
-            // All partitionings found, exiting
-            if (listOfKs.empty()) {
-                return;
-            }
-
-            element = listOfKs.back();
         }
     }
+    if (listOfKs.empty()) {
+        // All partitionings are written, nothing left to resume
+        if (checkpointing) {
+            std::remove(options.checkpointPath.c_str());
+        }
+        return;
+    }
 
 #if DEBUG > 0
     std::stringstream s;
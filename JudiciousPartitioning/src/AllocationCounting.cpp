@@ -0,0 +1,59 @@
+#include <cstdlib>
+#include <new>
+
+#include "MemoryAccounting.h"
+
+// Replaces the global allocation functions, so every operator new of the program is counted. Only the programs that
+// report the counts link this file, a program that embeds the library keeps its own allocation functions.
+
+void *operator new(size_t size) {
+    void *pointer = malloc(size == 0 ? 1 : size);
+    if (pointer == nullptr) {
+        throw std::bad_alloc();
+    }
+    MemoryAccounting::countAllocation(pointer);
+    return pointer;
+}
+
+void *operator new[](size_t size) {
+    return operator new(size);
+}
+
+void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    void *pointer = malloc(size == 0 ? 1 : size);
+    if (pointer != nullptr) {
+        MemoryAccounting::countAllocation(pointer);
+    }
+    return pointer;
+}
+
+void *operator new[](size_t size, const std::nothrow_t &tag) noexcept {
+    return operator new(size, tag);
+}
+
+void operator delete(void *pointer) noexcept {
+    if (pointer != nullptr) {
+        MemoryAccounting::countDeallocation(pointer);
+        free(pointer);
+    }
+}
+
+void operator delete[](void *pointer) noexcept {
+    operator delete(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    operator delete(pointer);
+}
+
+void operator delete[](void *pointer, size_t) noexcept {
+    operator delete(pointer);
+}
+
+void operator delete(void *pointer, const std::nothrow_t &) noexcept {
+    operator delete(pointer);
+}
+
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept {
+    operator delete(pointer);
+}
@@ -0,0 +1,162 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "AlignedBitArray.h"
+#include "SparseBitVector.h"
+
+// Microbenchmarks of the bit vectors behind EElem and SElem. Each benchmark runs for every width and number of ones in
+// datasetShapes, for both AlignedBitArray and SparseBitVector.
+
+// The number of hyperedges m of 59smallest, 59 and 59_single. All three have the hyperdegree cm = 57.
+static const std::vector<int64_t> datasetWidths = { 671, 10205, 18026 };
+static const int64_t datasetHyperdegree = 57;
+
+// Operations that modify their operand work on this many prepared copies before the next ones are prepared
+static const size_t batchSize = 1024;
+
+/**
+ * Uses the widths of the datasets with cm ones as in the first round, and with m/8 and m/2 ones as in the later
+ * rounds before k = 8 and k = 2.
+ */
+static void datasetShapes(benchmark::internal::Benchmark *benchmark) {
+    for (int64_t width : datasetWidths) {
+        for (int64_t ones : { datasetHyperdegree, width / 8, width / 2 }) {
+            benchmark->Args({ width, ones });
+        }
+    }
+    benchmark->ArgNames({ "bits", "ones" });
+}
+
+/**
+ * Creates a vector with the given number of ones at random positions.
+ */
+template <typename BitVector>
+static BitVector makeRandom(size_t numBits, size_t numOnes, std::mt19937_64 &generator) {
+    std::vector<size_t> positions(numBits);
+    std::iota(positions.begin(), positions.end(), 0);
+    std::shuffle(positions.begin(), positions.end(), generator);
+    BitVector result(numBits);
+    for (size_t i = 0; i < numOnes; i++) {
+        result.setBit(positions[i]);
+    }
+    return result;
+}
+
+/**
+ * Creates two independent random vectors with the shape of the benchmark's arguments.
+ */
+template <typename BitVector>
+static std::pair<BitVector, BitVector> makePair(const benchmark::State &state) {
+    std::mt19937_64 generator(42);
+    BitVector lhs = makeRandom<BitVector>(state.range(0), state.range(1), generator);
+    BitVector rhs = makeRandom<BitVector>(state.range(0), state.range(1), generator);
+    return std::make_pair(std::move(lhs), std::move(rhs));
+}
+
+template <typename BitVector>
+static void CalculateDistance(benchmark::State &state) {
+    auto operands = makePair<BitVector>(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(operands.first.calculateDistance(operands.second));
+    }
+}
+BENCHMARK_TEMPLATE(CalculateDistance, AlignedBitArray)->Apply(datasetShapes);
+BENCHMARK_TEMPLATE(CalculateDistance, SparseBitVector)->Apply(datasetShapes);
+
+// The covering case, which has to look at all bits
+template <typename BitVector>
+static void Covers(benchmark::State &state) {
+    auto operands = makePair<BitVector>(state);
+    BitVector covering = operands.first | operands.second;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(covering.covers(operands.second));
+    }
+}
+BENCHMARK_TEMPLATE(Covers, AlignedBitArray)->Apply(datasetShapes);
+BENCHMARK_TEMPLATE(Covers, SparseBitVector)->Apply(datasetShapes);
+
+template <typename BitVector>
+static void Or(benchmark::State &state) {
+    auto operands = makePair<BitVector>(state);
+    for (auto _ : state) {
+        BitVector result = operands.first | operands.second;
+        benchmark::DoNotOptimize(result);
+    }
+}
+BENCHMARK_TEMPLATE(Or, AlignedBitArray)->Apply(datasetShapes);
+BENCHMARK_TEMPLATE(Or, SparseBitVector)->Apply(datasetShapes);
+
+// Two vectors that only differ in their lowest set bit, the worst case for AlignedBitArray
+template <typename BitVector>
+static void Less(benchmark::State &state) {
+    auto operands = makePair<BitVector>(state);
+    BitVector greater(operands.first);
+    greater.setRightmost(operands.second);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(operands.first < greater);
+    }
+}
+BENCHMARK_TEMPLATE(Less, AlignedBitArray)->Apply(datasetShapes);
+BENCHMARK_TEMPLATE(Less, SparseBitVector)->Apply(datasetShapes);
+
+// As in the fill-up of findMinimalSubset, on fresh copies of the same vector
+template <typename BitVector>
+static void SetRightmost(benchmark::State &state) {
+    auto operands = makePair<BitVector>(state);
+    std::vector<BitVector> targets;
+    size_t next = batchSize;
+    for (auto _ : state) {
+        if (next == batchSize) {
+            state.PauseTiming();
+            targets.clear();
+            for (size_t i = 0; i < batchSize; i++) {
+                targets.emplace_back(operands.first);
+            }
+            next = 0;
+            state.ResumeTiming();
+        }
+        targets[next++].setRightmost(operands.second);
+    }
+}
+BENCHMARK_TEMPLATE(SetRightmost, AlignedBitArray)->Apply(datasetShapes);
+BENCHMARK_TEMPLATE(SetRightmost, SparseBitVector)->Apply(datasetShapes);
+
+template <typename BitVector>
+static void Hash(benchmark::State &state) {
+    auto operands = makePair<BitVector>(state);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(operands.first.hash());
+    }
+}
+BENCHMARK_TEMPLATE(Hash, AlignedBitArray)->Apply(datasetShapes);
+BENCHMARK_TEMPLATE(Hash, SparseBitVector)->Apply(datasetShapes);
+
+// Includes the allocation of the copy's buffer
+template <typename BitVector>
+static void CopyConstruct(benchmark::State &state) {
+    auto operands = makePair<BitVector>(state);
+    for (auto _ : state) {
+        BitVector copy(operands.first);
+        benchmark::DoNotOptimize(copy);
+    }
+}
+BENCHMARK_TEMPLATE(CopyConstruct, AlignedBitArray)->Apply(datasetShapes);
+BENCHMARK_TEMPLATE(CopyConstruct, SparseBitVector)->Apply(datasetShapes);
+
+// A move construction and the move assignment back into the source
+template <typename BitVector>
+static void MoveConstruct(benchmark::State &state) {
+    auto operands = makePair<BitVector>(state);
+    for (auto _ : state) {
+        BitVector moved(std::move(operands.first));
+        benchmark::DoNotOptimize(moved);
+        operands.first = std::move(moved);
+    }
+}
+BENCHMARK_TEMPLATE(MoveConstruct, AlignedBitArray)->Apply(datasetShapes);
+BENCHMARK_TEMPLATE(MoveConstruct, SparseBitVector)->Apply(datasetShapes);
+
+BENCHMARK_MAIN();
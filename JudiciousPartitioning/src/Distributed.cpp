@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+#include <string>
+#ifdef MPI_ENABLED
+#include <mpi.h>
+#endif
+
+#include "Distributed.h"
+
+#ifdef MPI_ENABLED
+/**
+ * Serializes the elements into one buffer with the format of SElem::writeTo.
+ */
+static std::string serialize(const std::vector<const SElem *> &elements) {
+    std::ostringstream stream(std::ios::binary);
+    for (const SElem *element : elements) {
+        element->writeTo(stream);
+    }
+    return stream.str();
+}
+
+/**
+ * Reads all elements from a buffer created by serialize and appends them to result.
+ */
+static void deserialize(const char *buffer, size_t size, std::vector<SElem> &result) {
+    std::istringstream stream(std::string(buffer, size), std::ios::binary);
+    while (stream.peek() != std::char_traits<char>::eof()) {
+        result.emplace_back(stream);
+        if (!stream) {
+            std::cerr << "Received a broken element of S" << std::endl;
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+    }
+}
+
+/**
+ * Turns sizes into the int displacements MPI expects. MPI counts are ints, so one exchange can move at most 2 GiB.
+ */
+static std::vector<int> getDisplacements(const std::vector<int> &sizes) {
+    std::vector<int> displacements(sizes.size(), 0);
+    for (size_t i = 1; i < sizes.size(); i++) {
+        displacements[i] = displacements[i - 1] + sizes[i - 1];
+    }
+    return displacements;
+}
+#endif
+
+void initDistributed(int &argc, char **&argv) {
+#ifdef MPI_ENABLED
+    // Only the thread running the rounds communicates, the TBB workers never call MPI
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_SERIALIZED, &provided);
+    if (provided < MPI_THREAD_SERIALIZED) {
+        std::cerr << "The MPI library does not support calls from more than one thread" << std::endl;
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+#else
+    (void) argc;
+    (void) argv;
+#endif
+}
+
+void finalizeDistributed() {
+#ifdef MPI_ENABLED
+    MPI_Finalize();
+#endif
+}
+
+void abortDistributed(int code) {
+#ifdef MPI_ENABLED
+    if (getNumRanks() > 1) {
+        MPI_Abort(MPI_COMM_WORLD, code);
+    }
+#else
+    (void) code;
+#endif
+}
+
+int getRank() {
+#ifdef MPI_ENABLED
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    return rank;
+#else
+    return 0;
+#endif
+}
+
+int getNumRanks() {
+#ifdef MPI_ENABLED
+    int numRanks;
+    MPI_Comm_size(MPI_COMM_WORLD, &numRanks);
+    return numRanks;
+#else
+    return 1;
+#endif
+}
+
+void allreduceMinimum(std::vector<uint64_t> &values) {
+#ifdef MPI_ENABLED
+    MPI_Allreduce(MPI_IN_PLACE, values.data(), static_cast<int>(values.size()), MPI_UINT64_T, MPI_MIN, MPI_COMM_WORLD);
+#else
+    (void) values;
+#endif
+}
+
+uint64_t allreduceSum(uint64_t value) {
+#ifdef MPI_ENABLED
+    MPI_Allreduce(MPI_IN_PLACE, &value, 1, MPI_UINT64_T, MPI_SUM, MPI_COMM_WORLD);
+#endif
+    return value;
+}
+
+std::vector<SElem> exchangeS(std::vector<SElem> &&local) {
+#ifdef MPI_ENABLED
+    int numRanks = getNumRanks();
+
+    // Serialize the elements for each owner
+    std::vector<std::vector<const SElem *>> outgoing(numRanks);
+    for (const SElem &currentS : local) {
+        outgoing[currentS.getHash() % numRanks].push_back(&currentS);
+    }
+    std::string sendBuffer;
+    std::vector<int> sendSizes(numRanks);
+    for (int rank = 0; rank < numRanks; rank++) {
+        std::string serialized = serialize(outgoing[rank]);
+        sendSizes[rank] = static_cast<int>(serialized.size());
+        sendBuffer += serialized;
+    }
+    local.clear();
+
+    std::vector<int> receiveSizes(numRanks);
+    MPI_Alltoall(sendSizes.data(), 1, MPI_INT, receiveSizes.data(), 1, MPI_INT, MPI_COMM_WORLD);
+    std::vector<int> sendDisplacements = getDisplacements(sendSizes);
+    std::vector<int> receiveDisplacements = getDisplacements(receiveSizes);
+    std::vector<char> receiveBuffer(receiveDisplacements.back() + receiveSizes.back());
+    MPI_Alltoallv(&sendBuffer[0], sendSizes.data(), sendDisplacements.data(), MPI_CHAR,
+                  receiveBuffer.data(), receiveSizes.data(), receiveDisplacements.data(), MPI_CHAR, MPI_COMM_WORLD);
+    sendBuffer.clear();
+
+    std::vector<SElem> received;
+    for (int rank = 0; rank < numRanks; rank++) {
+        deserialize(receiveBuffer.data() + receiveDisplacements[rank], receiveSizes[rank], received);
+    }
+
+    // Merge the elements that were found on several ranks
+    std::sort(received.begin(), received.end(), [](const SElem &lhs, const SElem &rhs) {
+        return lhs.getCombination() < rhs.getCombination();
+    });
+    std::vector<SElem> result;
+    for (SElem &currentS : received) {
+        if (!result.empty() && result.back().getCombination() == currentS.getCombination()) {
+            SElem &merged = result.back();
+            merged.getCoveredEElems().insert(currentS.getCoveredEElems().begin(), currentS.getCoveredEElems().end());
+            merged.getCoveredE0Elems().insert(currentS.getCoveredE0Elems().begin(), currentS.getCoveredE0Elems().end());
+        } else {
+            result.push_back(std::move(currentS));
+        }
+    }
+    return result;
+#else
+    return std::move(local);
+#endif
+}
+
+std::vector<std::pair<int, SElem>> allgatherCandidates(const SElem *candidate) {
+    std::vector<std::pair<int, SElem>> result;
+#ifdef MPI_ENABLED
+    int numRanks = getNumRanks();
+    std::string sendBuffer = candidate ? serialize({ candidate }) : std::string();
+    int sendSize = static_cast<int>(sendBuffer.size());
+
+    std::vector<int> receiveSizes(numRanks);
+    MPI_Allgather(&sendSize, 1, MPI_INT, receiveSizes.data(), 1, MPI_INT, MPI_COMM_WORLD);
+    std::vector<int> receiveDisplacements = getDisplacements(receiveSizes);
+    std::vector<char> receiveBuffer(receiveDisplacements.back() + receiveSizes.back());
+    MPI_Allgatherv(&sendBuffer[0], sendSize, MPI_CHAR,
+                   receiveBuffer.data(), receiveSizes.data(), receiveDisplacements.data(), MPI_CHAR, MPI_COMM_WORLD);
+
+    for (int rank = 0; rank < numRanks; rank++) {
+        if (receiveSizes[rank] == 0) {
+            continue;
+        }
+        std::vector<SElem> elements;
+        deserialize(receiveBuffer.data() + receiveDisplacements[rank], receiveSizes[rank], elements);
+        result.emplace_back(rank, std::move(elements[0]));
+    }
+#else
+    if (candidate) {
+        result.emplace_back(0, *candidate);
+    }
+#endif
+    return result;
+}
@@ -0,0 +1,147 @@
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <getopt.h>
+#include <sys/stat.h>
+#include <tbb/parallel_for.h>
+#include <tbb/task_arena.h>
+
+#include "DataDistribution.h"
+#include "Helper.h"
+#include "PartitionEvaluator.h"
+
+void printUsage(const char *program) {
+    std::cout << "Usage: " << program << " [options] repeats_file ddf_file..." << std::endl
+              << "Prints the worst and average number of repeat classes per CPU (RCC), the imbalance and the lower"
+              << " bound of the worst RCC of each DDF as a CSV line." << std::endl
+              << "Options:" << std::endl
+              << "  --threads N         Number of threads (default: one per core)" << std::endl
+              << "  --blocks FILE       Also write the RCC and number of sites of each CPU of each DDF to FILE as CSV" << std::endl;
+}
+
+static int run(int argc, char **argv) {
+    const char *program = argv[0];
+    size_t numThreads = 0;
+    std::string blocksPath;
+
+    // Parse options
+    const option longOptions[] = {
+            { "threads", required_argument, nullptr, 't' },
+            { "blocks", required_argument, nullptr, 'b' },
+            { nullptr, 0, nullptr, 0 }
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "", longOptions, nullptr)) != -1) {
+        switch (opt) {
+            case 't':
+                if (!parseNumber(optarg, numThreads)) {
+                    printUsage(program);
+                    return 1;
+                }
+                break;
+            case 'b':
+                blocksPath = optarg;
+                break;
+            default:
+                printUsage(program);
+                return 1;
+        }
+    }
+    argc -= optind - 1;
+    argv += optind - 1;
+
+    if (argc < 3) {
+        printUsage(program);
+        return 1;
+    }
+    std::string repeatsPath = argv[1];
+    struct stat buffer{};
+    if (stat(repeatsPath.c_str(), &buffer) != 0) {
+        std::cerr << "The provided repeats file doesn't exist." << std::endl;
+        return 1;
+    }
+    std::vector<std::string> ddfPaths(argv + 2, argv + argc);
+
+    tbb::task_arena arena(numThreads == 0 ? tbb::task_arena::automatic : static_cast<int>(numThreads));
+    std::vector<DataDistribution> distributions(ddfPaths.size());
+    std::vector<PartitionQuality> qualities(ddfPaths.size());
+    // Set if a DDF could not be read or does not fit the repeats file, a char per DDF as the threads write them
+    std::vector<char> failed(ddfPaths.size(), false);
+    arena.execute([&] {
+        tbb::parallel_for(size_t(0), ddfPaths.size(), [&](size_t i) {
+            std::ifstream file(ddfPaths[i]);
+            distributions[i] = DataDistribution(file);
+            failed[i] = !file;
+        });
+    });
+    for (size_t i = 0; i < ddfPaths.size(); i++) {
+        if (failed[i]) {
+            std::cerr << "Could not read the DDF " << ddfPaths[i] << std::endl;
+            return 1;
+        }
+    }
+
+    // Only the partitions that some DDF assigns are loaded
+    std::set<uint32_t> partitionNumbers;
+    for (const DataDistribution &distribution : distributions) {
+        for (const std::vector<DataDistribution::Assignment> &block : distribution.blocks) {
+            for (const DataDistribution::Assignment &assignment : block) {
+                partitionNumbers.insert(assignment.partition);
+            }
+        }
+    }
+    arena.execute([&] {
+        PartitionEvaluator evaluator(repeatsPath, partitionNumbers);
+        tbb::parallel_for(size_t(0), ddfPaths.size(), [&](size_t i) {
+            failed[i] = !evaluator.evaluate(distributions[i], qualities[i]);
+            // The sites are not needed any more
+            distributions[i] = DataDistribution();
+        });
+    });
+
+    std::cout << "file,k,worst_rcc,average_rcc,imbalance,worst_rcc_lower_bound" << std::endl << std::fixed;
+    for (size_t i = 0; i < ddfPaths.size(); i++) {
+        if (failed[i]) {
+            std::cerr << "The DDF " << ddfPaths[i] << " has sites that are not in " << repeatsPath
+                      << " or leaves sites of its partitions out" << std::endl;
+            return 1;
+        }
+        const PartitionQuality &quality = qualities[i];
+        std::cout << ddfPaths[i] << "," << quality.repeatClassesOfBlock.size() << "," << quality.getWorst() << ","
+                  << std::setprecision(2) << quality.getAverage() << "," << std::setprecision(4)
+                  << quality.getImbalance() << "," << quality.getWorstLowerBound() << std::endl;
+    }
+
+    if (!blocksPath.empty()) {
+        std::ofstream blocksFile(blocksPath);
+        blocksFile << "file,k,cpu,rcc,sites" << std::endl;
+        for (size_t i = 0; i < ddfPaths.size(); i++) {
+            const PartitionQuality &quality = qualities[i];
+            for (size_t block = 0; block < quality.repeatClassesOfBlock.size(); block++) {
+                blocksFile << ddfPaths[i] << "," << quality.repeatClassesOfBlock.size() << "," << block + 1 << ","
+                           << quality.repeatClassesOfBlock[block] << "," << quality.sitesOfBlock[block] << "\n";
+            }
+        }
+        if (!blocksFile) {
+            std::cerr << "Could not write the blocks to " << blocksPath << std::endl;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    // The library reports files it cannot read or write with exceptions
+    try {
+        return run(argc, argv);
+    } catch (const std::exception &exception) {
+        std::cerr << exception.what() << std::endl;
+        return 1;
+    }
+}
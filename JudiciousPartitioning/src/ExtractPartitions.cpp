@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <stdexcept>
+#include <string>
+
+#include <getopt.h>
+
+#include "Algorithms.h"
+#include "DDFWriter.h"
+#include "Helper.h"
+#include "MergeHierarchy.h"
+
+void printUsage(const char *program) {
+    std::cout << "Usage: " << program << " [--output-dir DIR | --output-container FILE] hierarchy_file k1[,k2[,k3...]]" << std::endl
+              << "Prints the partitions for each k, as JudiciousPartitioning does, from a file written by its"
+              << " --hierarchy option. The output options are the same as for JudiciousPartitioning." << std::endl;
+}
+
+static int run(int argc, char **argv) {
+    const char *program = argv[0];
+    DDFWriter::Target outputTarget = DDFWriter::Target::STDOUT;
+    std::string outputPath;
+
+    // Parse options
+    const option longOptions[] = {
+            { "output-dir", required_argument, nullptr, 'o' },
+            { "output-container", required_argument, nullptr, 'x' },
+            { nullptr, 0, nullptr, 0 }
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "", longOptions, nullptr)) != -1) {
+        switch (opt) {
+            case 'o':
+                outputTarget = DDFWriter::Target::DIRECTORY;
+                outputPath = optarg;
+                break;
+            case 'x':
+                outputTarget = DDFWriter::Target::CONTAINER;
+                outputPath = optarg;
+                break;
+            default:
+                printUsage(program);
+                return 1;
+        }
+    }
+    argc -= optind - 1;
+    argv += optind - 1;
+
+    if (argc != 3) {
+        printUsage(program);
+        return 1;
+    }
+
+    std::ifstream file(argv[1], std::ios::binary);
+    MergeHierarchy hierarchy(file);
+    if (!file) {
+        std::cerr << "Could not read the hierarchy from " << argv[1] << std::endl;
+        return 1;
+    }
+
+    // Largest k first, as the rounds find them
+    std::set<size_t> kSet = getKSetFromKString(argv[2]);
+    SitePartitioning partitioning;
+    DDFWriter writer(outputTarget, outputPath);
+    for (auto k = kSet.rbegin(); k != kSet.rend(); k++) {
+        if (!hierarchy.extract(*k, partitioning)) {
+            std::cerr << "The hierarchy does not reach k = " << *k << std::endl;
+            return 1;
+        }
+        std::vector<std::vector<size_t>> blocks = partitioning.getBlocks();
+    #ifdef DETERMINISM
+        std::sort(blocks.begin(), blocks.end());
+    #endif
+        writer.write(*k, blocks);
+    }
+
+    if (!writer.finish()) {
+        std::cerr << "Could not write the partitions" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    // The library reports files it cannot read or write with exceptions
+    try {
+        return run(argc, argv);
+    } catch (const std::exception &exception) {
+        std::cerr << exception.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,103 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <getopt.h>
+
+#include "Helper.h"
+#include "RepeatsGenerator.h"
+
+void printUsage(const char *program) {
+    std::cout << "Usage: " << program << " [options] output_file" << std::endl
+              << "Options:" << std::endl
+              << "  --sites N           Number of sites (default: 1000)" << std::endl
+              << "  --rows N            Number of rows, i.e. internal nodes of the tree (default: 57)" << std::endl
+              << "  --classes N         Maximum number of repeat classes per row (default: 200)" << std::endl
+              << "  --distribution D    Sizes of the repeat classes: uniform or zipf (default: zipf)" << std::endl
+              << "  --duplicates R      Share of sites that copy an earlier site, between 0 and 1 (default: 0.5)" << std::endl
+              << "  --seed N            Seed of the random number generator (default: 0)" << std::endl;
+}
+
+int main(int argc, char **argv) {
+    size_t numSites = 1000;
+    size_t numRows = 57;
+    size_t numRepeatClasses = 200;
+    RepeatClassDistribution distribution = RepeatClassDistribution::ZIPF;
+    double duplicateSiteRatio = 0.5;
+    size_t seed = 0;
+    const char *program = argv[0];
+
+    // Parse options
+    const option longOptions[] = {
+            { "sites", required_argument, nullptr, 's' },
+            { "rows", required_argument, nullptr, 'r' },
+            { "classes", required_argument, nullptr, 'c' },
+            { "distribution", required_argument, nullptr, 'd' },
+            { "duplicates", required_argument, nullptr, 'u' },
+            { "seed", required_argument, nullptr, 'e' },
+            { nullptr, 0, nullptr, 0 }
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "", longOptions, nullptr)) != -1) {
+        switch (opt) {
+            case 's':
+                if (!parseNumber(optarg, numSites)) {
+                    printUsage(program);
+                    return 1;
+                }
+                break;
+            case 'r':
+                if (!parseNumber(optarg, numRows)) {
+                    printUsage(program);
+                    return 1;
+                }
+                break;
+            case 'c':
+                if (!parseNumber(optarg, numRepeatClasses)) {
+                    printUsage(program);
+                    return 1;
+                }
+                break;
+            case 'd':
+                if (!parseRepeatClassDistribution(optarg, distribution)) {
+                    std::cerr << "Unknown repeat class distribution " << optarg << std::endl;
+                    return 1;
+                }
+                break;
+            case 'u':
+                if (!parseNumber(optarg, duplicateSiteRatio)) {
+                    printUsage(program);
+                    return 1;
+                }
+                if (duplicateSiteRatio > 1) {
+                    std::cerr << "The share of duplicate sites has to be between 0 and 1" << std::endl;
+                    return 1;
+                }
+                break;
+            case 'e':
+                if (!parseNumber(optarg, seed)) {
+                    printUsage(program);
+                    return 1;
+                }
+                break;
+            default:
+                printUsage(program);
+                return 1;
+        }
+    }
+
+    if (optind != argc - 1 || numSites == 0 || numRows == 0) {
+        printUsage(program);
+        return 1;
+    }
+
+    std::ofstream output(argv[optind]);
+    if (!output) {
+        std::cerr << "Could not create " << argv[optind] << std::endl;
+        return 1;
+    }
+    RepeatsGenerator(numSites, numRows, numRepeatClasses, distribution, duplicateSiteRatio, seed).writeTo(output);
+
+    return 0;
+}
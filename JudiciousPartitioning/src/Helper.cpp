@@ -1,53 +1,24 @@
-#include <map>
-#include <chrono>
+#include <cmath>
 #include <iostream>
 #include <sstream>
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/predicate.hpp>
 
 #include "Helper.h"
-
-std::map<std::string, uint64_t> measurements;
-std::map<std::string, std::chrono::time_point<std::chrono::high_resolution_clock>> measureStarts;
+#include "Profiler.h"
 
 void startTM(const std::string &identifier) {
-	if (measureStarts.count(identifier) != 0) {
-		std::cout << "The timer '" << identifier << "' is already running!" << std::endl;
-		abort();
-	}
-
-	measureStarts.emplace(identifier, std::chrono::high_resolution_clock::now());
+	Profiler::start(identifier);
 }
 
 void endTM(const std::string &identifier) {
-	if(measureStarts.count(identifier) == 0) {
-		std::cout << "The timer '" << identifier << "' isn't running!" << std::endl;
-		abort();
-	}
-
-	long time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - measureStarts.at(identifier)).count();
-	if (!measurements.count(identifier)) {
-		measurements.emplace(identifier, time);
-	} else {
-		measurements.at(identifier) += time;
-	}
-
-	measureStarts.erase(identifier);
+	Profiler::stop(identifier);
 }
 
 void printAllTM() {
-	if (!measureStarts.empty()) {
-		std::cout << "There is still a timer running: " << measureStarts.begin()->first << std::endl;
-		abort();
-	}
-
-	for (const auto &entry : measurements) {
-		if (entry.second < 10'000'000) {
-			std::cout << entry.first << ": " << entry.second / 1000 << "µs" << std::endl;
-		} else {
-			std::cout << entry.first << ": " << entry.second / 1000 / 1000 << "ms" << std::endl;
-		}
-	}
+	// The output ends in the runtime, which scripts read from the last line. The other phases go to stderr.
+	Profiler::printSummary(std::cerr, "Runtime", std::cout);
 }
 
 bool partitionsContainAllVertices(const Hypergraph &hypergraph, const std::vector<std::vector<size_t>> &partitions) {
@@ -67,9 +38,157 @@ std::vector<std::string> splitLineAtSpaces(const std::string &line) {
 	return splitLine;
 }
 
+/**
+ * Extract a set of k's from the string that is input on the command line.
+ * E.g., get {2, 4, 8} from "2,4,8"
+ */
+std::set<size_t> getKSetFromKString(std::string kString) {
+	std::set<size_t> kSet;
+
+	if (boost::contains(kString, ",")) {  // Input contains multiple elements
+		std::vector<std::string> splitKString;
+		boost::split(splitKString, kString, boost::is_any_of(","));
+
+		for (const auto &s : splitKString) {
+			size_t cur;
+			std::stringstream str(s);
+			str >> cur;
+			kSet.insert(cur);
+		}
+	} else {  // Input contains only one element
+		size_t k;
+		std::stringstream str(kString);
+		str >> k;
+		kSet.insert(k);
+	}
+
+	return kSet;
+}
+
 uint32_t stringToUint32t(const std::string &theString) {
 	uint32_t theInt;
 	std::istringstream iss(theString);
 	iss >> theInt;
 	return theInt;
-}
\ No newline at end of file
+}
+
+bool parseNumber(const std::string &text, double &number) {
+	std::istringstream stream(text);
+	double value;
+	if (!(stream >> value) || !stream.eof() || !std::isfinite(value) || value < 0) {
+		return false;
+	}
+	number = value;
+	return true;
+}
+
+bool parseNumber(const std::string &text, size_t &number) {
+	if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos) {
+		return false;
+	}
+	std::istringstream stream(text);
+	size_t value;
+	if (!(stream >> value)) {
+		return false;
+	}
+	number = value;
+	return true;
+}
+
+bool parseNumbers(const std::string &text, std::vector<size_t> &numbers) {
+	std::vector<std::string> elements;
+	boost::split(elements, text, boost::is_any_of(","));
+	std::vector<size_t> values(elements.size());
+	for (size_t i = 0; i < elements.size(); i++) {
+		if (!parseNumber(elements[i], values[i])) {
+			return false;
+		}
+	}
+	numbers = std::move(values);
+	return true;
+}
+
+void writeUint64(std::ostream &stream, uint64_t value) {
+	writeArray(stream, &value, 1);
+}
+
+uint64_t readUint64(std::istream &stream) {
+	uint64_t value = 0;
+	readArray(stream, &value, 1);
+	return stream ? value : 0;
+}
+
+template <typename T>
+void writeArray(std::ostream &stream, const T *values, size_t size) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	stream.write(reinterpret_cast<const char *>(values), sizeof(T) * size);
+#else
+	std::string buffer;
+	buffer.reserve(sizeof(T) * size);
+	for (size_t i = 0; i < size; i++) {
+		for (size_t byte = 0; byte < sizeof(T); byte++) {
+			buffer += static_cast<char>(values[i] >> (8 * byte) & 0xff);
+		}
+	}
+	stream.write(buffer.data(), buffer.size());
+#endif
+}
+
+template <typename T>
+void readArray(std::istream &stream, T *values, size_t size) {
+	stream.read(reinterpret_cast<char *>(values), sizeof(T) * size);
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+	for (size_t i = 0; i < size; i++) {
+		const unsigned char *bytes = reinterpret_cast<const unsigned char *>(values + i);
+		T value = 0;
+		for (size_t byte = sizeof(T); byte-- > 0;) {
+			value = value << 8 | bytes[byte];
+		}
+		values[i] = value;
+	}
+#endif
+}
+
+template void writeArray<uint32_t>(std::ostream &stream, const uint32_t *values, size_t size);
+template void writeArray<uint64_t>(std::ostream &stream, const uint64_t *values, size_t size);
+template void readArray<uint32_t>(std::istream &stream, uint32_t *values, size_t size);
+template void readArray<uint64_t>(std::istream &stream, uint64_t *values, size_t size);
+
+bool fitsInStream(std::istream &stream, uint64_t count, size_t elementSize) {
+	if (!stream) {
+		return false;
+	}
+	if (count <= 65536 / elementSize) {
+		return true;
+	}
+	std::istream::pos_type position = stream.tellg();
+	if (position == std::istream::pos_type(-1)) {
+		stream.clear();
+		return true;
+	}
+	stream.seekg(0, std::ios::end);
+	std::istream::pos_type end = stream.tellg();
+	stream.seekg(position);
+	if (!stream || end == std::istream::pos_type(-1) || count > static_cast<uint64_t>(end - position) / elementSize) {
+		stream.setstate(std::ios::failbit);
+		return false;
+	}
+	return true;
+}
+
+void writeIndexSet(std::ostream &stream, const std::set<uint32_t> &set) {
+	std::vector<uint32_t> elements(set.begin(), set.end());
+	writeUint64(stream, elements.size());
+	writeArray(stream, elements.data(), elements.size());
+}
+
+std::set<uint32_t> readIndexSet(std::istream &stream) {
+	uint64_t size = readUint64(stream);
+	if (!fitsInStream(stream, size, sizeof(uint32_t))) {
+		return std::set<uint32_t>();
+	}
+	std::vector<uint32_t> elements(size);
+	readArray(stream, elements.data(), elements.size());
+	// The elements were written in order, so every insert is a constant time hinted insert at the end
+	return std::set<uint32_t>(elements.begin(), elements.end());
+}
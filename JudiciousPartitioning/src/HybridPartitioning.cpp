@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <boost/algorithm/string/predicate.hpp>
+#include <tbb/parallel_for.h>
+
+#include "Algorithms.h"
+#include "HybridPartitioning.h"
+#include "Profiler.h"
+
+/**
+ * @return The number a CPU name ends in, or false if it does not end in one.
+ */
+static bool getCpuNumber(const std::string &cpu, uint64_t &number) {
+    size_t begin = cpu.find_last_not_of("0123456789") + 1;
+    if (begin == cpu.size() || cpu.size() - begin > 18) {
+        return false;
+    }
+    number = std::stoull(cpu.substr(begin));
+    return true;
+}
+
+bool readSplits(const std::string &path, std::vector<PartitionSplit> &splits) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+    splits.clear();
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!boost::starts_with(line, "partition")) {
+            continue;
+        }
+        std::istringstream header(line);
+        std::string partition;
+        size_t numCpus = 0;
+        header >> partition >> numCpus;
+        if (!header || partition.size() <= 10 || partition.find_first_not_of("0123456789", 10) != std::string::npos
+            || numCpus == 0) {
+            return false;
+        }
+        splits.push_back({ static_cast<uint32_t>(std::stoul(partition.substr(10))), {}, {} });
+        for (size_t i = 0; i < numCpus; i++) {
+            std::string cpu;
+            double proportion = 1;
+            uint64_t number = 0;
+            std::getline(file, line);
+            std::istringstream cpuLine(line);
+            cpuLine >> cpu;
+            if (!file || !cpuLine || !getCpuNumber(cpu, number)) {
+                return false;
+            }
+            // The share of a CPU that gets the whole partition is not needed. The others are scaled until each one
+            // rounds to at least 2, which needs them to be positive.
+            if (numCpus > 1 && (!(cpuLine >> proportion) || !(proportion > 0) || !std::isfinite(proportion))) {
+                return false;
+            }
+            splits.back().cpus.push_back(cpu);
+            splits.back().proportions.push_back(proportion);
+        }
+    }
+    return true;
+}
+
+std::vector<size_t> roundProportions(const std::vector<double> &proportions) {
+    std::vector<size_t> rounded(proportions.size());
+    for (double factor = 10;; factor += 10) {
+        bool allAtLeastTwo = true;
+        for (size_t i = 0; i < proportions.size(); i++) {
+            // Rounds half to even in the default rounding mode
+            rounded[i] = static_cast<size_t>(std::nearbyint(proportions[i] * factor));
+            allAtLeastTwo &= rounded[i] >= 2;
+        }
+        if (allAtLeastTwo) {
+            return rounded;
+        }
+    }
+}
+
+std::vector<std::vector<uint32_t>> mergeBlocks(const Hypergraph &hypergraph, const SitePartitioning &partitioning, const std::vector<size_t> &roundedProportions) {
+    const std::vector<hElem> &hyperedges = hypergraph.getHyperEdges();
+    std::vector<std::vector<uint32_t>> hyperedgesOfSite(hypergraph.getHypernodes().size());
+    for (uint32_t hyperedge = 0; hyperedge < hyperedges.size(); hyperedge++) {
+        for (uint32_t site : hyperedges[hyperedge]) {
+            hyperedgesOfSite[site].push_back(hyperedge);
+        }
+    }
+
+    // The repeat classes of each block, counted with a stamp per hyperedge
+    std::vector<std::vector<size_t>> blocks = partitioning.getBlocks();
+    std::vector<size_t> repeatClassesOfBlock(blocks.size(), 0);
+    std::vector<uint32_t> stamps(hyperedges.size(), UINT32_MAX);
+    for (uint32_t block = 0; block < blocks.size(); block++) {
+        for (size_t site : blocks[block]) {
+            for (uint32_t hyperedge : hyperedgesOfSite[site]) {
+                repeatClassesOfBlock[block] += stamps[hyperedge] != block;
+                stamps[hyperedge] = block;
+            }
+        }
+    }
+    std::vector<uint32_t> blockOrder(blocks.size());
+    for (uint32_t block = 0; block < blocks.size(); block++) {
+        blockOrder[block] = block;
+    }
+    std::stable_sort(blockOrder.begin(), blockOrder.end(), [&repeatClassesOfBlock](uint32_t lhs, uint32_t rhs) {
+        return repeatClassesOfBlock[lhs] > repeatClassesOfBlock[rhs];
+    });
+
+    // The goal of each merged block is its share of the repeat classes of the whole partition
+    size_t sumOfProportions = 0;
+    for (size_t proportion : roundedProportions) {
+        sumOfProportions += proportion;
+    }
+    std::vector<double> targets;
+    for (size_t proportion : roundedProportions) {
+        targets.push_back(static_cast<double>(proportion) / sumOfProportions * hyperedges.size());
+    }
+
+    std::vector<std::vector<uint32_t>> merged(roundedProportions.size());
+    std::vector<std::vector<bool>> hyperedgeOnMerged(merged.size(), std::vector<bool>(hyperedges.size(), false));
+    std::vector<size_t> repeatClassesOfMerged(merged.size(), 0);
+    for (uint32_t block : blockOrder) {
+        size_t mostMissing = 0;
+        for (size_t i = 1; i < merged.size(); i++) {
+            if (targets[i] - repeatClassesOfMerged[i] > targets[mostMissing] - repeatClassesOfMerged[mostMissing]) {
+                mostMissing = i;
+            }
+        }
+        for (size_t site : blocks[block]) {
+            merged[mostMissing].push_back(static_cast<uint32_t>(site));
+            for (uint32_t hyperedge : hyperedgesOfSite[site]) {
+                if (!hyperedgeOnMerged[mostMissing][hyperedge]) {
+                    hyperedgeOnMerged[mostMissing][hyperedge] = true;
+                    repeatClassesOfMerged[mostMissing]++;
+                }
+            }
+        }
+    }
+    for (std::vector<uint32_t> &sites : merged) {
+        std::sort(sites.begin(), sites.end());
+    }
+    return merged;
+}
+
+DataDistribution partitionSplits(JudiciousPartitioner &partitioner, const std::string &repeatsPath, const std::vector<PartitionSplit> &splits) {
+    std::set<uint32_t> partitionNumbers;
+    for (const PartitionSplit &split : splits) {
+        partitionNumbers.insert(split.partition);
+    }
+    std::map<uint32_t, Hypergraph> hypergraphs = getHypergraphsFromPartitionFile(repeatsPath, partitionNumbers);
+    std::vector<const Hypergraph *> hypergraphOfSplit;
+    for (const PartitionSplit &split : splits) {
+        auto hypergraph = hypergraphs.find(split.partition);
+        if (hypergraph == hypergraphs.end()) {
+            throw std::runtime_error(repeatsPath + " does not have partition_" + std::to_string(split.partition));
+        }
+        hypergraphOfSplit.push_back(&hypergraph->second);
+    }
+
+    // The sites of each CPU of each split. The split partitions run at the same time, so the rounds of a small
+    // partition do not wait for a large one, and all of them share the threads of the partitioner.
+    std::vector<std::vector<std::vector<uint32_t>>> sitesOfCpu(splits.size());
+    partitioner.execute([&] {
+        tbb::parallel_for(size_t(0), splits.size(), [&](size_t i) {
+            DetachedPhases detached;
+            const Hypergraph &hypergraph = *hypergraphOfSplit[i];
+            if (splits[i].cpus.size() == 1) {
+                sitesOfCpu[i].emplace_back(hypergraph.getHypernodes());
+                return;
+            }
+            std::vector<size_t> roundedProportions = roundProportions(splits[i].proportions);
+            size_t k = 0;
+            for (size_t proportion : roundedProportions) {
+                k += proportion;
+            }
+            std::vector<SitePartitioning> partitionings = partitioner.partition(hypergraph, { k });
+            sitesOfCpu[i] = mergeBlocks(hypergraph, partitionings.back(), roundedProportions);
+        }, tbb::simple_partitioner());
+    });
+
+    // The assignments of each CPU by its number, in the order of the splits
+    std::map<uint64_t, std::vector<DataDistribution::Assignment>> assignmentsOfCpu;
+    for (size_t i = 0; i < splits.size(); i++) {
+        for (size_t cpu = 0; cpu < splits[i].cpus.size(); cpu++) {
+            uint64_t number = 0;
+            getCpuNumber(splits[i].cpus[cpu], number);
+            assignmentsOfCpu[number].push_back({ splits[i].partition, std::move(sitesOfCpu[i][cpu]) });
+        }
+    }
+
+    DataDistribution distribution;
+    for (auto &cpu : assignmentsOfCpu) {
+        distribution.cpus.push_back("CPU" + std::to_string(cpu.first));
+        distribution.blocks.push_back(std::move(cpu.second));
+    }
+    return distribution;
+}
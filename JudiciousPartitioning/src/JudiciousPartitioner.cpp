@@ -0,0 +1,60 @@
+#include <algorithm>
+
+#include "JudiciousPartitioner.h"
+
+// ##### Constructors
+JudiciousPartitioner::JudiciousPartitioner(const PartitionOptions &options) :
+        options(options),
+        // One work stealing scheduler for all phases, so their tasks never compete for the cores
+        arena(options.numThreads == 0 ? tbb::task_arena::automatic : static_cast<int>(options.numThreads)) {
+    if (options.numaMode != NumaMode::OFF || !options.cpus.empty()) {
+        pinning.reset(new ThreadPinning(arena, options.cpus));
+    }
+    if (PerfCounters::isEnabled()) {
+        counters.reset(new PerfCounters::ThreadObserver(arena));
+    }
+}
+
+// ##### Functions
+void JudiciousPartitioner::execute(const std::function<void()> &function) {
+    arena.execute(function);
+}
+
+void JudiciousPartitioner::partition(const Hypergraph &hypergraph, const std::set<size_t> &ks, const PartitioningConsumer &consumer, PartitionState *state) {
+    arena.execute([&] {
+        if (options.engine == Engine::MULTILEVEL) {
+            partitionMultilevel(hypergraph, ks, options, consumer);
+        } else if (options.refinement) {
+            // Refined blocks keep the exact flag of their round, they are never worse than its blocks
+            PartitionRefiner refiner(hypergraph);
+            ::partition(hypergraph, ks, options, refiner.wrap(options, consumer), state);
+        } else {
+            ::partition(hypergraph, ks, options, consumer, state);
+        }
+    });
+}
+
+std::vector<SitePartitioning> JudiciousPartitioner::partition(const Hypergraph &hypergraph, const std::set<size_t> &ks) {
+    std::vector<SitePartitioning> partitionings;
+    partition(hypergraph, ks, [&partitionings](const SitePartitioning &partitioning) {
+        partitionings.push_back(partitioning);
+    });
+    std::reverse(partitionings.begin(), partitionings.end());
+    return partitionings;
+}
+
+std::vector<SitePartitioning> JudiciousPartitioner::partition(const std::vector<std::vector<uint32_t>> &rows, const std::set<size_t> &ks) {
+    return partition(Hypergraph::fromRepeatClasses(rows), ks);
+}
+
+MergeHierarchy JudiciousPartitioner::partitionHierarchy(const Hypergraph &hypergraph, size_t minimumK, PartitionState *state) {
+    PartitionState localState;
+    if (state == nullptr) {
+        state = &localState;
+    }
+    // Refined blocks do not nest, so the hierarchy always comes from the exact engine
+    arena.execute([&] {
+        ::partition(hypergraph, { minimumK }, options, [](const SitePartitioning &) {}, state);
+    });
+    return state->recorder.finish();
+}
@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+#include "Profiler.h"
+#include "PartitionRefiner.h"
+#include "Multilevel.h"
+
+static uint32_t findRoot(std::vector<uint32_t> &parent, uint32_t hyperedge) {
+    while (parent[hyperedge] != hyperedge) {
+        parent[hyperedge] = parent[parent[hyperedge]];
+        hyperedge = parent[hyperedge];
+    }
+    return hyperedge;
+}
+
+/**
+ * Builds the hypergraph of the merged hyperedges, each the union of the sites of its original hyperedges.
+ */
+static Hypergraph mergeHyperedges(const Hypergraph &hypergraph, std::vector<uint32_t> &parent) {
+    const std::vector<hElem> &hyperedges = hypergraph.getHyperEdges();
+    std::vector<uint32_t> mergedIndex(hyperedges.size(), UINT32_MAX);
+    std::vector<hElem> merged;
+    for (uint32_t hyperedge = 0; hyperedge < hyperedges.size(); hyperedge++) {
+        // The root is the smallest original hyperedge, so it comes first
+        uint32_t root = findRoot(parent, hyperedge);
+        if (mergedIndex[root] == UINT32_MAX) {
+            mergedIndex[root] = static_cast<uint32_t>(merged.size());
+            merged.emplace_back();
+        }
+        hElem &target = merged[mergedIndex[root]];
+        target.insert(target.end(), hyperedges[hyperedge].begin(), hyperedges[hyperedge].end());
+    }
+    for (hElem &hyperedge : merged) {
+        std::sort(hyperedge.begin(), hyperedge.end());
+        hyperedge.erase(std::unique(hyperedge.begin(), hyperedge.end()), hyperedge.end());
+    }
+    return Hypergraph(hypergraph.getHypernodes(), std::move(merged));
+}
+
+Hypergraph coarsenHypergraph(const Hypergraph &hypergraph, size_t targetSites) {
+    ScopedPhase phase("coarsen");
+    const std::vector<hElem> &hyperedges = hypergraph.getHyperEdges();
+
+    // The hyperedges of a site ascend with the rows, so the i-th hyperedges of two sites belong to the same row
+    std::vector<std::vector<uint32_t>> hyperedgesOfSite(hypergraph.getHypernodes().size());
+    for (uint32_t hyperedge = 0; hyperedge < hyperedges.size(); hyperedge++) {
+        for (uint32_t site : hyperedges[hyperedge]) {
+            hyperedgesOfSite[site].push_back(hyperedge);
+        }
+    }
+    std::vector<uint32_t> parent(hyperedges.size());
+    std::iota(parent.begin(), parent.end(), 0);
+
+    // Neighbours in locality order that are considered for a match
+    const size_t window = 8;
+    Hypergraph coarse = hypergraph;
+    for (size_t level = 0;; level++) {
+        std::vector<EElem> e = generateE(coarse);
+        DEBUG_LOG(DEBUG_PROGRESS, "Coarsening level " + std::to_string(level) + ": " + std::to_string(e.size()) + " distinct sites\n");
+        if (e.size() <= targetSites) {
+            break;
+        }
+
+        std::vector<uint32_t> order = getLocalityOrder(e);
+        std::vector<bool> matched(e.size(), false);
+        size_t numMatches = 0;
+        for (size_t position = 0; position < order.size(); position++) {
+            uint32_t first = order[position];
+            if (matched[first]) {
+                continue;
+            }
+            size_t bestDistance = SIZE_MAX;
+            uint32_t best = first;
+            for (size_t other = position + 1; other < std::min(order.size(), position + window + 1); other++) {
+                uint32_t second = order[other];
+                if (!matched[second]) {
+                    size_t distance = e[first].getCombination().calculateDistance(e[second].getCombination());
+                    if (distance < bestDistance) {
+                        bestDistance = distance;
+                        best = second;
+                    }
+                }
+            }
+            if (best == first) {
+                continue;
+            }
+            matched[first] = true;
+            matched[best] = true;
+            numMatches++;
+
+            // Any site of the two stands for all of its element of E
+            const std::vector<uint32_t> &firstHyperedges = hyperedgesOfSite[*e[first].getCoveredE0Elems().begin()];
+            const std::vector<uint32_t> &secondHyperedges = hyperedgesOfSite[*e[best].getCoveredE0Elems().begin()];
+            for (size_t row = 0; row < std::min(firstHyperedges.size(), secondHyperedges.size()); row++) {
+                uint32_t firstRoot = findRoot(parent, firstHyperedges[row]);
+                uint32_t secondRoot = findRoot(parent, secondHyperedges[row]);
+                parent[std::max(firstRoot, secondRoot)] = std::min(firstRoot, secondRoot);
+            }
+        }
+        if (numMatches == 0) {
+            break;
+        }
+        coarse = mergeHyperedges(hypergraph, parent);
+    }
+    return coarse;
+}
+
+void partitionMultilevel(const Hypergraph &hypergraph, const std::set<size_t> &setOfKs, const PartitionOptions &options, const PartitioningConsumer &consumer) {
+    // A checkpoint would hold the rounds on the coarse hypergraph under the key of the original one
+    if (!options.checkpointPath.empty()) {
+        throw std::invalid_argument("The multilevel engine does not support checkpoints");
+    }
+    // The blocks of a k are made of distinct coarse sites, so fewer of them than k would leave blocks empty
+    Hypergraph coarse = coarsenHypergraph(hypergraph, std::max(options.coarseningTarget, *setOfKs.rbegin()));
+    DEBUG_LOG(DEBUG_PROGRESS, "Coarse hyperedges: " + std::to_string(coarse.getHyperEdges().size()) + "\n");
+    PartitionRefiner refiner(hypergraph);
+    PartitioningConsumer approximateConsumer = [&consumer](const SitePartitioning &partitioning) {
+        SitePartitioning approximate = partitioning;
+        approximate.exact = false;
+        consumer(approximate);
+    };
+    partition(coarse, setOfKs, options, refiner.wrap(options, approximateConsumer));
+}
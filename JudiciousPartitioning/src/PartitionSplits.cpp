@@ -0,0 +1,110 @@
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <getopt.h>
+#include <sys/stat.h>
+
+#include "Algorithms.h"
+#include "DataDistribution.h"
+#include "Helper.h"
+#include "HybridPartitioning.h"
+#include "JudiciousPartitioner.h"
+
+void printUsage(const char *program) {
+    std::cout << "Usage: " << program << " [options] repeats_file splits_file" << std::endl
+              << "Prints the hybrid data distribution for the shares of the split partitions in a splits file of RDDA."
+              << " Each split partition is partitioned for the k of its rounded shares and its blocks are merged to the"
+              << " shares." << std::endl
+              << "Options:" << std::endl
+              << "  --threads N         Number of threads (default: one per core)" << std::endl
+              << "  --engine ENGINE     exact, or multilevel to partition a coarsened hypergraph and refine (default: exact)" << std::endl
+              << "  --refine            Move sites between blocks to lower the maximum number of repeat classes per block" << std::endl
+              << "  --output FILE       Write the distribution to FILE instead of printing it" << std::endl;
+}
+
+static int run(int argc, char **argv) {
+    const char *program = argv[0];
+    PartitionOptions options;
+    std::string outputPath;
+
+    // Parse options
+    const option longOptions[] = {
+            { "threads", required_argument, nullptr, 't' },
+            { "engine", required_argument, nullptr, 'e' },
+            { "refine", no_argument, nullptr, 'f' },
+            { "output", required_argument, nullptr, 'o' },
+            { nullptr, 0, nullptr, 0 }
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "", longOptions, nullptr)) != -1) {
+        switch (opt) {
+            case 't':
+                if (!parseNumber(optarg, options.numThreads)) {
+                    printUsage(program);
+                    return 1;
+                }
+                break;
+            case 'e':
+                if (!parseEngine(optarg, options.engine)) {
+                    std::cerr << "Unknown engine " << optarg << std::endl;
+                    return 1;
+                }
+                break;
+            case 'f':
+                options.refinement = true;
+                break;
+            case 'o':
+                outputPath = optarg;
+                break;
+            default:
+                printUsage(program);
+                return 1;
+        }
+    }
+    argc -= optind - 1;
+    argv += optind - 1;
+
+    if (argc != 3) {
+        printUsage(program);
+        return 1;
+    }
+    struct stat buffer{};
+    if (stat(argv[1], &buffer) != 0) {
+        std::cerr << "The provided repeats file doesn't exist." << std::endl;
+        return 1;
+    }
+    std::vector<PartitionSplit> splits;
+    if (!readSplits(argv[2], splits)) {
+        std::cerr << "Could not read the splits from " << argv[2] << std::endl;
+        return 1;
+    }
+
+    JudiciousPartitioner partitioner(options);
+    DataDistribution distribution = partitionSplits(partitioner, argv[1], splits);
+
+    if (outputPath.empty()) {
+        distribution.writeTo(std::cout);
+        std::cout.flush();
+        return std::cout ? 0 : 1;
+    }
+    std::ofstream output(outputPath);
+    distribution.writeTo(output);
+    if (!output) {
+        std::cerr << "Could not write the distribution to " << outputPath << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    // The library reports files it cannot read or write with exceptions
+    try {
+        return run(argc, argv);
+    } catch (const std::exception &exception) {
+        std::cerr << exception.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,198 @@
+#include <benchmark/benchmark.h>
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <memory>
+#include <thread>
+#include <tbb/task_arena.h>
+
+#include "Algorithms.h"
+#include "Hypergraph.h"
+#include "JudiciousPartitioner.h"
+#include "RepeatsGenerator.h"
+
+// Benchmarks of the whole pipeline on the bundled datasets. Each benchmark takes the index of the dataset and the
+// number of threads of the task arena as arguments.
+
+#ifndef DATASETS_DIR
+#define DATASETS_DIR "../datasets"
+#endif
+
+static const std::vector<std::string> datasets = { "59smallest", "59", "59_single" };
+
+// The ks partition is benchmarked with
+static const std::set<size_t> benchmarkKs = { 2, 4, 8, 16 };
+
+static std::string getDatasetPath(size_t dataset) {
+    return std::string(DATASETS_DIR) + "/" + datasets[dataset] + ".repeats";
+}
+
+/**
+ * Parses each dataset once and keeps it for all benchmarks.
+ */
+static const Hypergraph &getHypergraph(size_t dataset) {
+    static std::map<size_t, Hypergraph> hypergraphs;
+    auto found = hypergraphs.find(dataset);
+    if (found == hypergraphs.end()) {
+        found = hypergraphs.emplace(dataset, getHypergraphFromPartitionFile(getDatasetPath(dataset), 0)).first;
+    }
+    return found->second;
+}
+
+/**
+ * Generates each synthetic partition once and keeps it. Apart from the number of sites, they are shaped like the
+ * bundled datasets: 57 rows, up to 200 repeat classes of Zipf distributed sizes and half of the sites
+ * duplicates.
+ */
+static const Hypergraph &getSyntheticHypergraph(size_t numSites) {
+    static std::map<size_t, Hypergraph> hypergraphs;
+    auto found = hypergraphs.find(numSites);
+    if (found == hypergraphs.end()) {
+        RepeatsGenerator generator(numSites, 57, 200, RepeatClassDistribution::ZIPF, 0.5, 42);
+        found = hypergraphs.emplace(numSites, generator.generateHypergraph()).first;
+    }
+    return found->second;
+}
+
+/**
+ * Sweeps each dataset with 1, 2, 4, ... threads up to the number of cores. The threads are those of the task arena
+ * the phases run in. Benchmark's own Threads() would instead run independent copies of the benchmark side by side.
+ */
+static void datasetsAndThreads(benchmark::internal::Benchmark *benchmark) {
+    size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t dataset = 0; dataset < datasets.size(); dataset++) {
+        for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+            benchmark->Args({ static_cast<int64_t>(dataset), static_cast<int64_t>(threads) });
+        }
+    }
+    benchmark->ArgNames({ "dataset", "threads" })->Unit(benchmark::kMillisecond);
+}
+
+/**
+ * Provides the parsed dataset, its set E and a task arena with the wanted number of threads.
+ */
+class Pipeline : public benchmark::Fixture {
+protected:
+    const Hypergraph *hypergraph = nullptr;
+    std::vector<EElem> e;
+    size_t cm = 0;
+    std::unique_ptr<tbb::task_arena> arena;
+    PartitionOptions options;
+
+public:
+    void SetUp(const benchmark::State &state) override {
+        hypergraph = &getHypergraph(state.range(0));
+        options.numThreads = state.range(1);
+        arena.reset(new tbb::task_arena(static_cast<int>(options.numThreads)));
+        arena->execute([this] {
+            e = generateE(*hypergraph);
+        });
+        cm = e[0].countOnes();
+    }
+
+    void TearDown(const benchmark::State &) override {
+        e.clear();
+        arena.reset();
+    }
+};
+
+static void Parse(benchmark::State &state) {
+    for (auto _ : state) {
+        Hypergraph hypergraph = getHypergraphFromPartitionFile(getDatasetPath(state.range(0)), 0);
+        benchmark::DoNotOptimize(hypergraph);
+    }
+    state.SetLabel(datasets[state.range(0)]);
+}
+BENCHMARK(Parse)->DenseRange(0, static_cast<int>(datasets.size()) - 1)->ArgName("dataset")->Unit(benchmark::kMillisecond);
+
+BENCHMARK_DEFINE_F(Pipeline, GenerateE)(benchmark::State &state) {
+    for (auto _ : state) {
+        arena->execute([this] {
+            std::vector<EElem> result = generateE(*hypergraph);
+            benchmark::DoNotOptimize(result);
+        });
+    }
+    state.SetLabel(datasets[state.range(0)]);
+}
+BENCHMARK_REGISTER_F(Pipeline, GenerateE)->Apply(datasetsAndThreads);
+
+// The first round, on the set E of the dataset
+BENCHMARK_DEFINE_F(Pipeline, GenerateS)(benchmark::State &state) {
+    for (auto _ : state) {
+        arena->execute([this] {
+            MinimalDistances minimalDistances;
+            RoundStatistics statistics;
+            std::vector<SElem> s = generateS(cm + 1, e, options, minimalDistances, statistics);
+            benchmark::DoNotOptimize(s);
+        });
+    }
+    state.SetLabel(datasets[state.range(0)]);
+}
+BENCHMARK_REGISTER_F(Pipeline, GenerateS)->Apply(datasetsAndThreads);
+
+// The first round, findMinimalSubset needs the minimal distances of the generateS before it
+BENCHMARK_DEFINE_F(Pipeline, FindMinimalSubset)(benchmark::State &state) {
+    for (auto _ : state) {
+        state.PauseTiming();
+        MinimalDistances minimalDistances;
+        RoundStatistics statistics;
+        std::vector<SElem> s;
+        arena->execute([&] {
+            s = generateS(cm + 1, e, options, minimalDistances, statistics);
+        });
+        state.ResumeTiming();
+
+        arena->execute([&] {
+            std::vector<EElem> sStar = findMinimalSubset(e, std::move(s), minimalDistances, statistics);
+            benchmark::DoNotOptimize(sStar);
+        });
+    }
+    state.SetLabel(datasets[state.range(0)]);
+}
+BENCHMARK_REGISTER_F(Pipeline, FindMinimalSubset)->Apply(datasetsAndThreads);
+
+// All rounds up to the smallest k, returning the partitionings in memory
+BENCHMARK_DEFINE_F(Pipeline, Partition)(benchmark::State &state) {
+    JudiciousPartitioner partitioner(options);
+    for (auto _ : state) {
+        std::vector<SitePartitioning> partitionings = partitioner.partition(*hypergraph, benchmarkKs);
+        benchmark::DoNotOptimize(partitionings);
+    }
+    state.SetLabel(datasets[state.range(0)]);
+}
+BENCHMARK_REGISTER_F(Pipeline, Partition)->Apply(datasetsAndThreads)->Iterations(1);
+
+// A whole run on a synthetic partition, the first argument is its number of sites
+static void SyntheticPartition(benchmark::State &state) {
+    const Hypergraph &hypergraph = getSyntheticHypergraph(state.range(0));
+    PartitionOptions options;
+    options.numThreads = state.range(1);
+    JudiciousPartitioner partitioner(options);
+    for (auto _ : state) {
+        std::vector<SitePartitioning> partitionings = partitioner.partition(hypergraph, benchmarkKs);
+        benchmark::DoNotOptimize(partitionings);
+    }
+}
+
+// The same partition with 1, 2, 4, ... threads
+static void strongScaling(benchmark::internal::Benchmark *benchmark) {
+    size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        benchmark->Args({ 2000, static_cast<int64_t>(threads) });
+    }
+    benchmark->ArgNames({ "sites", "threads" })->Unit(benchmark::kMillisecond)->Iterations(1);
+}
+BENCHMARK(SyntheticPartition)->Name("SyntheticPartition/StrongScaling")->Apply(strongScaling);
+
+// The pair scan is quadratic in the size of E, so the sites grow with the square root of the threads to keep the work
+// per thread about the same
+static void weakScaling(benchmark::internal::Benchmark *benchmark) {
+    size_t maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        benchmark->Args({ static_cast<int64_t>(1000 * std::sqrt(threads)), static_cast<int64_t>(threads) });
+    }
+    benchmark->ArgNames({ "sites", "threads" })->Unit(benchmark::kMillisecond)->Iterations(1);
+}
+BENCHMARK(SyntheticPartition)->Name("SyntheticPartition/WeakScaling")->Apply(weakScaling);
+
+BENCHMARK_MAIN();
@@ -1,5 +1,6 @@
 #include <iostream>
 #include "AlignedBitArray.h"
+#include "Helper.h"
 
 // PRIVATE STATIC
 AlignedBitArray::ptr_type AlignedBitArray::malloc_aligned(size_t numInts) {
@@ -8,6 +9,7 @@ AlignedBitArray::ptr_type AlignedBitArray::malloc_aligned(size_t numInts) {
         std::cerr << "Aligned malloc failed!" << std::endl;
         throw std::bad_alloc();
     }
+    MemoryAccounting::countAllocation(raw);
     return ptr_type(raw);
 }
 
@@ -16,6 +18,15 @@ AlignedBitArray::AlignedBitArray(size_t numBits) : numBits(numBits), numInts(num
     memset(bitarray.get(), 0, sizeof(uint64_t) * numInts);
 }
 
+AlignedBitArray::AlignedBitArray(std::istream &stream) {
+    uint64_t bits = readUint64(stream);
+    numBits = fitsInStream(stream, bits / 64 + 1, sizeof(uint64_t)) ? bits : 0;
+    numInts = numBits / 64 + 1;
+    bitarray = malloc_aligned(numInts);
+    memset(bitarray.get(), 0, sizeof(uint64_t) * numInts);
+    readArray(stream, bitarray.get(), numInts);
+}
+
 AlignedBitArray::AlignedBitArray(const AlignedBitArray &other) : numBits(other.numBits), numInts(other.numInts), bitarray(malloc_aligned(numInts))  {
     memcpy(bitarray.get(), other.bitarray.get(), sizeof(uint64_t) * numInts);
 }
@@ -111,6 +122,10 @@ size_t AlignedBitArray::getNumInts() const {
     return numInts;
 }
 
+size_t AlignedBitArray::getMemoryUsage() const {
+    return sizeof(AlignedBitArray) + (bitarray ? sizeof(uint64_t) * numInts : 0);
+}
+
 bool AlignedBitArray::getBit(size_t i) const {
     assert(i < numBits);
     size_t diff = numBits - i - 1;
@@ -144,10 +159,15 @@ bool AlignedBitArray::covers(const AlignedBitArray &rhs) const {
 
 size_t AlignedBitArray::calculateDistance(const AlignedBitArray &rhs) const {
     assert(numInts == rhs.numInts && numBits == rhs.numBits);
+    return calculateDistance(bitarray.get(), rhs.bitarray.get(), numInts);
+}
+
+// STATIC
+size_t AlignedBitArray::calculateDistance(const uint64_t *lhs, const uint64_t *rhs, size_t numInts) {
     size_t result = 0;
     for (size_t i = 0; i < numInts; i++) {
         // Runtime 50:50
-        result += __builtin_popcountll(bitarray[i] ^ rhs[i]);
+        result += __builtin_popcountll(lhs[i] ^ rhs[i]);
     }
     return result;
 }
@@ -163,6 +183,58 @@ void AlignedBitArray::setRightmost(const AlignedBitArray &rhs) {
     }
 }
 
+uint64_t AlignedBitArray::hash() const {
+    const uint64_t prime = 0x9E3779B97F4A7C15;
+    const size_t numLanes = 4;
+
+    // Independent lanes, so the inner loop maps onto one vector register
+    uint64_t lanes[numLanes] = { numBits, prime, ~numBits, ~prime };
+    size_t i = 0;
+    for (; i + numLanes <= numInts; i += numLanes) {
+        for (size_t j = 0; j < numLanes; j++) {
+            uint64_t mixed = lanes[j] ^ bitarray[i + j];
+            lanes[j] = ((mixed << 31) | (mixed >> 33)) * prime;
+        }
+    }
+
+    // Finish sequentially
+    for (size_t j = 0; i < numInts; i++, j++) {
+        uint64_t mixed = lanes[j] ^ bitarray[i];
+        lanes[j] = ((mixed << 31) | (mixed >> 33)) * prime;
+    }
+
+    // Fold the lanes and finalize, so that the low bits depend on all input bits
+    uint64_t result = 0;
+    for (uint64_t lane : lanes) {
+        result = (result ^ lane ^ (lane >> 29)) * prime;
+    }
+    result ^= result >> 32;
+    return result;
+}
+
+void AlignedBitArray::writeTo(std::ostream &stream) const {
+    writeUint64(stream, numBits);
+    writeArray(stream, bitarray.get(), numInts);
+}
+
+bool AlignedBitArray::grayCodeLess(const AlignedBitArray &rhs) const {
+    assert(numInts == rhs.numInts && numBits == rhs.numBits);
+    // Parity of the ones both arrays share above the first differing bit
+    size_t parity = 0;
+    for (size_t i = 0; i < numInts; i++) {
+        uint64_t diff = bitarray[i] ^ rhs[i];
+        if (diff) {
+            uint64_t firstDiff = 0x8000000000000000 >> __builtin_clzll(diff);
+            parity += __builtin_popcountll(bitarray[i] & ~((firstDiff << 1) - 1));
+            bool hasBit = (bitarray[i] & firstDiff) != 0;
+            // An odd number of ones above reverses the order of the remaining bits
+            return parity % 2 == 0 ? !hasBit : hasBit;
+        }
+        parity += __builtin_popcountll(bitarray[i]);
+    }
+    return false;
+}
+
 
 
 //bool AlignedBitArray::covers(const AlignedBitArray &rhs) const {
@@ -0,0 +1,50 @@
+#include <cstdio>
+#include <fstream>
+#include <unistd.h>
+
+#include "Checkpoint.h"
+#include "Helper.h"
+
+// Marks the checkpoint files, "JPCKPT" in little endian
+static const uint64_t magic = 0x54504B43504A;
+
+bool writeCheckpoint(const std::string &path, uint64_t key, const std::vector<size_t> &remainingKs, const PartitionState &state) {
+    std::string temporaryPath = path + "." + std::to_string(getpid());
+    {
+        std::ofstream file(temporaryPath, std::ios::binary);
+        writeUint64(file, magic);
+        writeUint64(file, key);
+        writeUint64(file, remainingKs.size());
+        for (uint64_t k : remainingKs) {
+            writeUint64(file, k);
+        }
+        state.writeTo(file);
+        file.close();
+        if (!file) {
+            std::remove(temporaryPath.c_str());
+            return false;
+        }
+    }
+    return std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+}
+
+bool readCheckpoint(const std::string &path, uint64_t &key, std::vector<size_t> &remainingKs, PartitionState &state) {
+    std::ifstream file(path, std::ios::binary);
+    uint64_t fileMagic = readUint64(file);
+    key = readUint64(file);
+    uint64_t numKs = readUint64(file);
+    if (!file || fileMagic != magic || !fitsInStream(file, numKs, sizeof(uint64_t))) {
+        return false;
+    }
+    remainingKs.clear();
+    for (uint64_t i = 0; file && i < numKs; i++) {
+        remainingKs.push_back(readUint64(file));
+    }
+
+    PartitionState loaded(file);
+    if (!file || loaded.d == 0 || loaded.e.empty() || loaded.recorder.getNumRounds() != loaded.d) {
+        return false;
+    }
+    state = std::move(loaded);
+    return true;
+}
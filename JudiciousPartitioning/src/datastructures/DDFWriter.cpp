@@ -0,0 +1,164 @@
+#include <cerrno>
+#include <iostream>
+#include <stdexcept>
+
+#include <sys/stat.h>
+
+#include "DDFWriter.h"
+#include "Helper.h"
+
+// Ends the container file, "JPDDFIDX" in little endian
+static const uint64_t magic = 0x5844494646445041;
+
+// Bytes of an index entry in the container, its k, offset and length
+static const uint64_t entrySize = 3 * sizeof(uint64_t);
+
+/**
+ * Appends the decimal digits of a number, without the detour over a stream and its locale.
+ */
+static void appendNumber(std::string &buffer, uint64_t number) {
+    char digits[20];
+    char *begin = digits + sizeof(digits);
+    do {
+        *--begin = static_cast<char>('0' + number % 10);
+        number /= 10;
+    } while (number != 0);
+    buffer.append(begin, digits + sizeof(digits));
+}
+
+// ##### Constructors
+DDFWriter::DDFWriter(Target target, const std::string &path) : target(target), path(path) {
+    if (target == Target::DIRECTORY) {
+        struct stat status;
+        if (mkdir(path.c_str(), 0755) != 0 && (errno != EEXIST || stat(path.c_str(), &status) != 0 || !S_ISDIR(status.st_mode))) {
+            throw std::runtime_error("Could not create the DDF directory " + path);
+        }
+    } else if (target == Target::CONTAINER) {
+        container.open(path, std::ios::binary);
+        if (!container) {
+            throw std::runtime_error("Could not create the DDF container " + path);
+        }
+    }
+}
+
+DDFWriter::~DDFWriter() {
+    finish();
+}
+
+// ##### Functions
+void DDFWriter::format(std::string &buffer, size_t k, const std::vector<std::vector<size_t>> &partitions) {
+    size_t numSites = 0;
+    for (const std::vector<size_t> &partition : partitions) {
+        numSites += partition.size();
+    }
+    // Most site identifiers have at most 6 digits plus a space, the lines add a few bytes per partition
+    buffer.reserve(buffer.size() + 7 * numSites + 32 * partitions.size() + 24);
+
+    appendNumber(buffer, k);
+    buffer += '\n';
+    size_t partitionCounter = 1;
+    for (const std::vector<size_t> &partition : partitions) {
+        buffer += "CPU";
+        appendNumber(buffer, partitionCounter++);
+        buffer += " 1\npartition_0 ";
+        appendNumber(buffer, partition.size());
+        for (size_t hypernode : partition) {
+            buffer += ' ';
+            appendNumber(buffer, hypernode);
+        }
+        buffer += '\n';
+    }
+}
+
+bool DDFWriter::write(size_t k, const std::vector<std::vector<size_t>> &partitions) {
+    std::string buffer;
+    format(buffer, k, partitions);
+
+    if (target == Target::DIRECTORY) {
+        std::ofstream file(path + "/" + std::to_string(k) + ".ddf", std::ios::binary);
+        file.write(buffer.data(), buffer.size());
+        std::lock_guard<std::mutex> lock(mutex);
+        failed |= !file;
+        return static_cast<bool>(file);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (target == Target::STDOUT) {
+        std::cout.write(buffer.data(), buffer.size());
+        failed |= !std::cout;
+        return static_cast<bool>(std::cout);
+    }
+    container.write(buffer.data(), buffer.size());
+    index.push_back({ k, offset, buffer.size() });
+    offset += buffer.size();
+    failed |= !container;
+    return static_cast<bool>(container);
+}
+
+bool DDFWriter::finish() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (target == Target::STDOUT) {
+        std::cout.flush();
+        failed |= !std::cout;
+    } else if (target == Target::CONTAINER && container.is_open()) {
+        for (const IndexEntry &entry : index) {
+            writeUint64(container, entry.k);
+            writeUint64(container, entry.offset);
+            writeUint64(container, entry.length);
+        }
+        writeUint64(container, index.size());
+        writeUint64(container, magic);
+        container.close();
+        failed |= !container;
+
+        // Reads the index back, so a container that a reader cannot open does not count as written
+        if (!failed) {
+            try {
+                std::vector<IndexEntry> readBack = readIndex(path);
+                failed |= readBack.size() != index.size();
+                for (size_t i = 0; !failed && i < index.size(); i++) {
+                    failed |= readBack[i].k != index[i].k || readBack[i].offset != index[i].offset
+                              || readBack[i].length != index[i].length;
+                }
+            } catch (const std::runtime_error &) {
+                failed = true;
+            }
+        }
+    }
+    return !failed;
+}
+
+std::vector<DDFWriter::IndexEntry> DDFWriter::readIndex(const std::string &path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        throw std::runtime_error("Could not open the DDF container " + path);
+    }
+    uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    uint64_t numEntries = 0;
+    if (fileSize >= 16 && file.seekg(fileSize - 16)) {
+        numEntries = readUint64(file);
+    }
+    if (readUint64(file) != magic) {
+        throw std::runtime_error(path + " is not a DDF container");
+    }
+    if (numEntries > (fileSize - 16) / entrySize) {
+        throw std::runtime_error("The index of the DDF container " + path + " is corrupted");
+    }
+
+    // The DDFs lie before the index
+    uint64_t dataSize = fileSize - 16 - numEntries * entrySize;
+    std::vector<IndexEntry> entries(numEntries);
+    file.seekg(dataSize);
+    for (IndexEntry &entry : entries) {
+        entry.k = readUint64(file);
+        entry.offset = readUint64(file);
+        entry.length = readUint64(file);
+        if (!file) {
+            throw std::runtime_error("Could not read the index of the DDF container " + path);
+        }
+        if (entry.offset > dataSize || entry.length > dataSize - entry.offset) {
+            throw std::runtime_error("The index of the DDF container " + path + " is corrupted");
+        }
+    }
+    return entries;
+}
@@ -0,0 +1,53 @@
+#include <string>
+
+#include "DataDistribution.h"
+
+// ##### Constructors
+DataDistribution::DataDistribution(std::istream &stream) {
+    size_t k = 0;
+    stream >> k;
+    for (size_t block = 0; stream && block < k; block++) {
+        std::string cpu;
+        size_t numAssignments = 0;
+        stream >> cpu >> numAssignments;
+        cpus.push_back(cpu);
+        blocks.emplace_back();
+        for (size_t i = 0; stream && i < numAssignments; i++) {
+            std::string partition;
+            size_t numSites = 0;
+            stream >> partition >> numSites;
+            if (partition.compare(0, 10, "partition_") != 0 || partition.size() == 10
+                || partition.find_first_not_of("0123456789", 10) != std::string::npos) {
+                stream.setstate(std::ios::failbit);
+                return;
+            }
+            blocks.back().push_back({ static_cast<uint32_t>(std::stoul(partition.substr(10))), {} });
+            std::vector<uint32_t> &sites = blocks.back().back().sites;
+            // A malformed count must not allocate more than the stream can fill
+            uint32_t site = 0;
+            for (size_t j = 0; j < numSites && stream >> site; j++) {
+                sites.push_back(site);
+            }
+        }
+    }
+}
+
+// ##### Getters/Setters
+size_t DataDistribution::getK() const {
+    return blocks.size();
+}
+
+// ##### Functions
+void DataDistribution::writeTo(std::ostream &stream) const {
+    stream << getK() << "\n";
+    for (size_t block = 0; block < getK(); block++) {
+        stream << cpus[block] << " " << blocks[block].size() << "\n";
+        for (const Assignment &assignment : blocks[block]) {
+            stream << "partition_" << assignment.partition << " " << assignment.sites.size();
+            for (uint32_t site : assignment.sites) {
+                stream << " " << site;
+            }
+            stream << "\n";
+        }
+    }
+}
@@ -1,20 +1,37 @@
 #include "EElem.h"
+#include "Helper.h"
 
 // ##### Constructors
-EElem::EElem(size_t numBits) : combination(BitRepresentation(numBits)) {
+EElem::EElem(size_t numBits) :
+        combination(BitRepresentation(numBits)),
+        combinationHash(combination.hash()),
+        signature(combination) {
 }
 
 EElem::EElem(BitRepresentation combination, std::set <uint32_t> coveredE0Elems) :
         combination(std::move(combination)),
+        combinationHash(this->combination.hash()),
+        signature(this->combination),
         coveredE0Elems(std::move(coveredE0Elems)) {
 }
 
-EElem::EElem(SElem &&original) : combination(std::move(original.getCombination())), coveredE0Elems(std::move(original.getCoveredE0Elems())) {
+EElem::EElem(SElem &&original) :
+        combination(std::move(original.getCombination())),
+        combinationHash(original.getHash()),
+        signature(combination),
+        coveredE0Elems(std::move(original.getCoveredE0Elems())) {
+}
+
+EElem::EElem(std::istream &stream) :
+        combination(stream),
+        combinationHash(combination.hash()),
+        signature(combination),
+        coveredE0Elems(readIndexSet(stream)) {
 }
 
 // ##### Operators
 bool operator==(const EElem &lhs, const EElem &rhs) {
-    return lhs.combination == rhs.combination;
+    return lhs.combinationHash == rhs.combinationHash && lhs.combination == rhs.combination;
 }
 
 bool operator!=(const EElem &lhs, const EElem &rhs) {
@@ -54,6 +71,36 @@ std::set<uint32_t> &EElem::getCoveredE0Elems() {
     return coveredE0Elems;
 }
 
+uint64_t EElem::getHash() const {
+    return combinationHash;
+}
+
+const Signature &EElem::getSignature() const {
+    return signature;
+}
+
 size_t EElem::countOnes() const {
     return combination.countOnes();
 }
+
+size_t EElem::getMemoryUsage() const {
+    return sizeof(EElem) - sizeof(BitRepresentation) + combination.getMemoryUsage() + getCoveredE0MemoryUsage();
+}
+
+size_t EElem::getCoveredE0MemoryUsage() const {
+    return coveredE0Elems.size() * SET_NODE_BYTES;
+}
+
+// ##### Functions
+void EElem::updateHash() {
+    combinationHash = combination.hash();
+}
+
+void EElem::updateSignature() {
+    signature = Signature(combination);
+}
+
+void EElem::writeTo(std::ostream &stream) const {
+    combination.writeTo(stream);
+    writeIndexSet(stream, coveredE0Elems);
+}
@@ -6,6 +6,38 @@ Hypergraph::Hypergraph(std::vector<uint32_t> hypernodes, std::vector<std::vector
         hyperedges(std::move(hyperedges)) {
 }
 
+Hypergraph Hypergraph::fromRepeatClasses(const std::vector<std::vector<uint32_t>> &rows) {
+    size_t numberOfSites = rows.empty() ? 0 : rows[0].size();
+
+    std::vector<uint32_t> hypernodes;
+    for (uint32_t j = 0; j < numberOfSites; j++) {
+        hypernodes.push_back(j);
+    }
+
+    // Sort the sites of each row into their classes, there can be a maximum of numberOfSites repeat classes per row
+    std::vector<hElem> hyperedges;
+    std::vector<hElem> classes;
+    for (const std::vector<uint32_t> &row : rows) {
+        classes.clear();
+        for (uint32_t k = 0; k < numberOfSites; k++) {
+            if (row[k] < numberOfSites) {
+                if (row[k] >= classes.size()) {
+                    classes.resize(row[k] + 1);
+                }
+                classes[row[k]].push_back(k);
+            }
+        }
+        for (hElem &repeatClass : classes) {
+            if (repeatClass.empty()) {  // No site contains this repeat class --> none will contain any "higher" one
+                break;
+            }
+            hyperedges.push_back(std::move(repeatClass));
+        }
+    }
+
+    return Hypergraph(std::move(hypernodes), std::move(hyperedges));
+}
+
 // ##### Getters/Setters
 const std::vector<uint32_t> &Hypergraph::getHypernodes() const {
     return hypernodes;
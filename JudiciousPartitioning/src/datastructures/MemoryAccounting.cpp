@@ -0,0 +1,101 @@
+#include <atomic>
+#include <malloc.h>
+
+#include "MemoryAccounting.h"
+
+namespace {
+    // A thread adds its counts to the shared counters once they reach these limits
+    const int64_t flushBytes = 256 * 1024;
+    const uint64_t flushAllocations = 1024;
+
+    std::atomic<int64_t> liveBytes{0};
+    std::atomic<uint64_t> numAllocations{0};
+
+    // The high-water marks of the phases measured at the moment, one slot each. A slot is claimed in usedPeaks, then
+    // set to the live bytes and only after that marked in activePeaks, which the flushes raise.
+    const int maxPeaks = 64;
+    std::atomic<int64_t> peaks[maxPeaks];
+    std::atomic<uint64_t> usedPeaks{0};
+    std::atomic<uint64_t> activePeaks{0};
+
+    // Trivially destructible, so allocations while a thread ends can still use it. The counts of a thread that ends
+    // before its next flush are lost.
+    struct ThreadCounts {
+        int64_t bytes;
+        uint64_t allocations;
+    };
+    thread_local ThreadCounts threadCounts = { 0, 0 };
+
+    void raise(std::atomic<int64_t> &peak, int64_t live) {
+        int64_t current = peak.load(std::memory_order_relaxed);
+        while (live > current && !peak.compare_exchange_weak(current, live, std::memory_order_relaxed)) {
+        }
+    }
+
+    void flush() {
+        int64_t live = liveBytes.fetch_add(threadCounts.bytes, std::memory_order_relaxed) + threadCounts.bytes;
+        numAllocations.fetch_add(threadCounts.allocations, std::memory_order_relaxed);
+        for (uint64_t active = activePeaks.load(std::memory_order_acquire); active != 0; active &= active - 1) {
+            raise(peaks[__builtin_ctzll(active)], live);
+        }
+        threadCounts = { 0, 0 };
+    }
+
+    void count(int64_t bytes, uint64_t allocations) {
+        threadCounts.bytes += bytes;
+        threadCounts.allocations += allocations;
+        if (threadCounts.bytes >= flushBytes || threadCounts.bytes <= -flushBytes || threadCounts.allocations >= flushAllocations) {
+            flush();
+        }
+    }
+}
+
+// ##### Getters/Setters
+int64_t MemoryAccounting::getLiveBytes() {
+    flush();
+    return liveBytes.load(std::memory_order_relaxed);
+}
+
+uint64_t MemoryAccounting::getNumAllocations() {
+    flush();
+    return numAllocations.load(std::memory_order_relaxed);
+}
+
+// ##### Functions
+void MemoryAccounting::countAllocation(void *pointer) {
+    count(static_cast<int64_t>(malloc_usable_size(pointer)), 1);
+}
+
+void MemoryAccounting::countDeallocation(void *pointer) {
+    count(-static_cast<int64_t>(malloc_usable_size(pointer)), 0);
+}
+
+void MemoryAccounting::countBytes(int64_t bytes) {
+    count(bytes, bytes > 0 ? 1 : 0);
+}
+
+int MemoryAccounting::beginPeak() {
+    flush();
+    uint64_t used = usedPeaks.load(std::memory_order_relaxed);
+    int slot;
+    do {
+        if (~used == 0) {
+            return -1;
+        }
+        slot = __builtin_ctzll(~used);
+    } while (!usedPeaks.compare_exchange_weak(used, used | uint64_t(1) << slot, std::memory_order_relaxed));
+    peaks[slot].store(liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    activePeaks.fetch_or(uint64_t(1) << slot, std::memory_order_release);
+    return slot;
+}
+
+int64_t MemoryAccounting::endPeak(int slot) {
+    flush();
+    if (slot < 0) {
+        return 0;
+    }
+    activePeaks.fetch_and(~(uint64_t(1) << slot), std::memory_order_relaxed);
+    int64_t peak = peaks[slot].load(std::memory_order_relaxed);
+    usedPeaks.fetch_and(~(uint64_t(1) << slot), std::memory_order_release);
+    return peak;
+}
@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <cassert>
+
+#include "Helper.h"
+#include "MergeHierarchy.h"
+
+// Marks the files of writeTo, "JPMH" in little endian
+static const uint32_t magic = 0x484D504A;
+
+static void writeVector(std::ostream &stream, const std::vector<uint32_t> &array) {
+    writeArray(stream, array.data(), array.size());
+}
+
+/**
+ * Reads size elements into array, or none if they do not fit in the stream.
+ */
+static void readVector(std::istream &stream, std::vector<uint32_t> &array, uint64_t size) {
+    array.resize(fitsInStream(stream, size, sizeof(uint32_t)) ? size : 0);
+    readArray(stream, array.data(), array.size());
+}
+
+// ##### Constructors
+MergeHierarchy::Recorder::Recorder(const std::vector<EElem> &e, size_t numSites) : levels(1, std::vector<uint32_t>(numSites)) {
+    for (uint32_t eidx = 0; eidx < e.size(); eidx++) {
+        for (uint32_t site : e[eidx].getCoveredE0Elems()) {
+            levels[0][site] = eidx;
+        }
+        representatives.push_back(*e[eidx].getCoveredE0Elems().begin());
+    }
+}
+
+MergeHierarchy::Recorder::Recorder(std::istream &stream) {
+    uint64_t numLevels = readUint64(stream);
+    for (uint64_t level = 0; stream && level < numLevels; level++) {
+        uint64_t size = readUint64(stream);
+        levels.emplace_back();
+        readVector(stream, levels.back(), size);
+    }
+    readVector(stream, representatives, readUint64(stream));
+}
+
+MergeHierarchy::MergeHierarchy(std::istream &stream) {
+    uint32_t fileMagic = 0;
+    readArray(stream, &fileMagic, 1);
+    if (stream && fileMagic != magic) {
+        stream.setstate(std::ios::failbit);
+    }
+    uint64_t numSites = readUint64(stream);
+    readVector(stream, siteOrder, numSites);
+
+    uint64_t numRounds = readUint64(stream);
+    for (uint64_t round = 0; stream && round < numRounds; round++) {
+        uint64_t k = readUint64(stream);
+        blockBegins.emplace_back();
+        blockSizes.emplace_back();
+        readVector(stream, blockBegins.back(), k);
+        readVector(stream, blockSizes.back(), k);
+    }
+
+    // extract writes to the sites of siteOrder in the ranges of the blocks, so these have to lie within it
+    if (!stream) {
+        return;
+    }
+    for (uint32_t site : siteOrder) {
+        if (site >= siteOrder.size()) {
+            stream.setstate(std::ios::failbit);
+        }
+    }
+    for (size_t round = 0; round < blockBegins.size(); round++) {
+        for (size_t block = 0; block < blockBegins[round].size(); block++) {
+            if (blockBegins[round][block] > siteOrder.size() || blockSizes[round][block] > siteOrder.size() - blockBegins[round][block]) {
+                stream.setstate(std::ios::failbit);
+            }
+        }
+    }
+}
+
+// ##### Getters/Setters
+size_t MergeHierarchy::Recorder::getNumSites() const {
+    return levels.empty() ? 0 : levels[0].size();
+}
+
+size_t MergeHierarchy::Recorder::getNumRounds() const {
+    return levels.empty() ? 0 : levels.size() - 1;
+}
+
+size_t MergeHierarchy::getNumSites() const {
+    return siteOrder.size();
+}
+
+size_t MergeHierarchy::getNumRounds() const {
+    return blockBegins.size();
+}
+
+size_t MergeHierarchy::getK(size_t round) const {
+    return blockBegins[round].size();
+}
+
+// ##### Functions
+void MergeHierarchy::Recorder::addRound(const std::vector<EElem> &sStar) {
+    std::vector<uint32_t> blockOfSite(levels[0].size());
+    for (uint32_t block = 0; block < sStar.size(); block++) {
+        for (uint32_t site : sStar[block].getCoveredE0Elems()) {
+            blockOfSite[site] = block;
+        }
+    }
+
+    // The previous blocks are merged as a whole, so any of their sites tells where they went
+    std::vector<uint32_t> parents(representatives.size());
+    for (size_t i = 0; i < representatives.size(); i++) {
+        parents[i] = blockOfSite[representatives[i]];
+    }
+    levels.push_back(std::move(parents));
+
+    representatives.clear();
+    for (const EElem &block : sStar) {
+        representatives.push_back(*block.getCoveredE0Elems().begin());
+    }
+}
+
+void MergeHierarchy::Recorder::writeTo(std::ostream &stream) const {
+    writeUint64(stream, levels.size());
+    for (const std::vector<uint32_t> &level : levels) {
+        writeUint64(stream, level.size());
+        writeVector(stream, level);
+    }
+    writeUint64(stream, representatives.size());
+    writeVector(stream, representatives);
+}
+
+MergeHierarchy MergeHierarchy::Recorder::finish() const {
+    MergeHierarchy result;
+    size_t numRounds = levels.size() - 1;
+
+    // Order the nodes of each level by the position of their parent, from the last round down to the sites. A
+    // counting sort keeps the children of a parent together and in their original order.
+    std::vector<uint32_t> order(representatives.size());
+    for (uint32_t i = 0; i < order.size(); i++) {
+        order[i] = i;
+    }
+    for (size_t level = levels.size(); level-- > 0;) {
+        const std::vector<uint32_t> &parents = levels[level];
+        std::vector<uint32_t> positionOfParent(order.size());
+        for (uint32_t position = 0; position < order.size(); position++) {
+            positionOfParent[order[position]] = position;
+        }
+        std::vector<uint32_t> offsets(order.size() + 1, 0);
+        for (uint32_t parent : parents) {
+            offsets[positionOfParent[parent] + 1]++;
+        }
+        for (size_t i = 1; i < offsets.size(); i++) {
+            offsets[i] += offsets[i - 1];
+        }
+        std::vector<uint32_t> childOrder(parents.size());
+        for (uint32_t child = 0; child < parents.size(); child++) {
+            childOrder[offsets[positionOfParent[parents[child]]]++] = child;
+        }
+        order = std::move(childOrder);
+    }
+    result.siteOrder = std::move(order);
+
+    // Each node covers the range of its children, starting with the sites themselves
+    std::vector<uint32_t> begins(result.siteOrder.size());
+    std::vector<uint32_t> sizes(result.siteOrder.size(), 1);
+    for (uint32_t position = 0; position < result.siteOrder.size(); position++) {
+        begins[result.siteOrder[position]] = position;
+    }
+    for (size_t level = 0; level <= numRounds; level++) {
+        const std::vector<uint32_t> &parents = levels[level];
+        size_t numParents = level < numRounds ? levels[level + 1].size() : representatives.size();
+        std::vector<uint32_t> parentBegins(numParents, UINT32_MAX);
+        std::vector<uint32_t> parentSizes(numParents, 0);
+        for (uint32_t child = 0; child < parents.size(); child++) {
+            parentBegins[parents[child]] = std::min(parentBegins[parents[child]], begins[child]);
+            parentSizes[parents[child]] += sizes[child];
+        }
+        begins = std::move(parentBegins);
+        sizes = std::move(parentSizes);
+        if (level > 0) {
+            result.blockBegins.push_back(begins);
+            result.blockSizes.push_back(sizes);
+        }
+    }
+
+    return result;
+}
+
+bool MergeHierarchy::extract(size_t k, SitePartitioning &partitioning) const {
+    for (size_t round = 0; round < getNumRounds(); round++) {
+        if (getK(round) <= k) {
+            partitioning.k = k;
+            partitioning.blockOfSite.resize(siteOrder.size());
+            for (uint32_t block = 0; block < getK(round); block++) {
+                uint32_t end = blockBegins[round][block] + blockSizes[round][block];
+                for (uint32_t position = blockBegins[round][block]; position < end; position++) {
+                    partitioning.blockOfSite[siteOrder[position]] = block;
+                }
+            }
+            return true;
+        }
+    }
+    return false;
+}
+
+void MergeHierarchy::writeTo(std::ostream &stream) const {
+    writeArray(stream, &magic, 1);
+    writeUint64(stream, siteOrder.size());
+    writeVector(stream, siteOrder);
+    writeUint64(stream, getNumRounds());
+    for (size_t round = 0; round < getNumRounds(); round++) {
+        writeUint64(stream, getK(round));
+        writeVector(stream, blockBegins[round]);
+        writeVector(stream, blockSizes[round]);
+    }
+}
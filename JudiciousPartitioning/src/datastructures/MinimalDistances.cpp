@@ -0,0 +1,59 @@
+#include <cassert>
+
+#include "MinimalDistances.h"
+
+// ##### Getters/Setters
+size_t MinimalDistances::size() const {
+    return numElements;
+}
+
+size_t MinimalDistances::getMemoryUsage() const {
+    return numElements * sizeof(std::atomic<uint64_t>);
+}
+
+size_t MinimalDistances::getDistance(size_t eidx) const {
+    return entries[eidx].load(std::memory_order_relaxed) >> 32;
+}
+
+uint32_t MinimalDistances::getIndex(size_t eidx) const {
+    return static_cast<uint32_t>(entries[eidx].load(std::memory_order_relaxed));
+}
+
+// ##### Functions
+void MinimalDistances::reset(size_t numElements) {
+    if (numElements != this->numElements) {
+        entries.reset(new std::atomic<uint64_t>[numElements]);
+        this->numElements = numElements;
+    }
+    for (size_t eidx = 0; eidx < numElements; eidx++) {
+        entries[eidx].store(UINT64_MAX, std::memory_order_relaxed);
+    }
+}
+
+void MinimalDistances::lower(size_t eidx, size_t distance, uint32_t otherEidx) {
+    assert(distance < UINT32_MAX);
+    uint64_t candidate = static_cast<uint64_t>(distance) << 32 | otherEidx;
+    std::atomic<uint64_t> &entry = entries[eidx];
+    uint64_t current = entry.load(std::memory_order_relaxed);
+    while (candidate < current && !entry.compare_exchange_weak(current, candidate, std::memory_order_relaxed)) {
+    }
+}
+
+bool MinimalDistances::cannotLower(size_t eidx, size_t lowerBound, uint32_t otherEidx) const {
+    return (static_cast<uint64_t>(lowerBound) << 32 | otherEidx) >= entries[eidx].load(std::memory_order_relaxed);
+}
+
+std::vector<uint64_t> MinimalDistances::getEntries() const {
+    std::vector<uint64_t> result(numElements);
+    for (size_t eidx = 0; eidx < numElements; eidx++) {
+        result[eidx] = entries[eidx].load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+void MinimalDistances::setEntries(const std::vector<uint64_t> &newEntries) {
+    assert(newEntries.size() == numElements);
+    for (size_t eidx = 0; eidx < numElements; eidx++) {
+        entries[eidx].store(newEntries[eidx], std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,180 @@
+#include <algorithm>
+#include <iostream>
+#include <thread>
+#include <sched.h>
+#include <tbb/parallel_for.h>
+#ifdef NUMA_ENABLED
+#include <numa.h>
+#endif
+
+#include "NumaPlacement.h"
+
+// Node of the core the current thread is pinned to, -1 if it is not pinned
+static thread_local int currentNode = -1;
+
+// The affinity and node of the current thread before each entry that pinned it, innermost last
+struct SavedPinning {
+    cpu_set_t cpuSet;
+    int node;
+};
+static thread_local std::vector<SavedPinning> savedPinnings;
+
+bool parseNumaMode(const std::string &name, NumaMode &mode) {
+    if (name == "off") {
+        mode = NumaMode::OFF;
+        return true;
+    }
+#ifdef NUMA_ENABLED
+    if (name == "replicate") {
+        mode = NumaMode::REPLICATE;
+        return true;
+    }
+    if (name == "interleave") {
+        mode = NumaMode::INTERLEAVE;
+        return true;
+    }
+#endif
+    return false;
+}
+
+// ##### Constructors
+ThreadPinning::ThreadPinning(tbb::task_arena &arena, const std::vector<size_t> &cpus) : tbb::task_scheduler_observer(arena) {
+    for (size_t cpu : cpus) {
+        this->cpus.push_back(static_cast<int>(cpu));
+        int node = 0;
+#ifdef NUMA_ENABLED
+        if (numa_available() >= 0) {
+            node = std::max(0, numa_node_of_cpu(static_cast<int>(cpu)));
+        }
+#endif
+        nodes.push_back(node);
+    }
+
+#ifdef NUMA_ENABLED
+    if (this->cpus.empty() && numa_available() >= 0) {
+        bitmask *nodeCpus = numa_allocate_cpumask();
+        for (int node = 0; node <= numa_max_node(); node++) {
+            if (numa_node_to_cpus(node, nodeCpus) != 0) {
+                continue;
+            }
+            for (unsigned int cpu = 0; cpu < nodeCpus->size; cpu++) {
+                if (numa_bitmask_isbitset(nodeCpus, cpu)) {
+                    this->cpus.push_back(cpu);
+                    nodes.push_back(node);
+                }
+            }
+        }
+        numa_free_cpumask(nodeCpus);
+    }
+#endif
+
+    // Without NUMA information, every core counts as node 0
+    if (this->cpus.empty()) {
+        for (unsigned int cpu = 0; cpu < std::thread::hardware_concurrency(); cpu++) {
+            this->cpus.push_back(cpu);
+            nodes.push_back(0);
+        }
+    }
+
+    observe(true);
+}
+
+ThreadPinning::~ThreadPinning() {
+    observe(false);
+}
+
+// ##### Functions
+void ThreadPinning::on_scheduler_entry(bool isWorker) {
+    int slot = tbb::this_task_arena::current_thread_index();
+    if (cpus.empty() || slot < 0) {
+        return;
+    }
+
+    // Arenas can be entered from within each other, each exit gives back what its entry found
+    SavedPinning saved;
+    if (sched_getaffinity(0, sizeof(saved.cpuSet), &saved.cpuSet) != 0) {
+        return;
+    }
+    saved.node = currentNode;
+
+    size_t cpu = static_cast<size_t>(slot) % cpus.size();
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpus[cpu], &cpuSet);
+    if (sched_setaffinity(0, sizeof(cpuSet), &cpuSet) != 0) {
+        std::cerr << "Could not pin a thread to core " << cpus[cpu] << std::endl;
+        return;
+    }
+    savedPinnings.push_back(saved);
+    currentNode = nodes[cpu];
+}
+
+void ThreadPinning::on_scheduler_exit(bool isWorker) {
+    // Nothing to give back if the entry did not pin, or if the thread entered before the observation started
+    if (savedPinnings.empty()) {
+        return;
+    }
+    SavedPinning saved = savedPinnings.back();
+    savedPinnings.pop_back();
+    sched_setaffinity(0, sizeof(saved.cpuSet), &saved.cpuSet);
+    currentNode = saved.node;
+}
+
+int ThreadPinning::getCurrentNode() {
+    return currentNode == -1 ? 0 : currentNode;
+}
+
+// ##### Constructors
+EReplicas::EReplicas(const std::vector<EElem> &e, NumaMode mode) : e(e) {
+#ifdef NUMA_ENABLED
+    if (mode == NumaMode::OFF || numa_available() < 0 || e.empty()) {
+        return;
+    }
+    numInts = e[0].getCombination().getNumInts();
+
+    if (mode == NumaMode::REPLICATE) {
+        replicas.resize(numa_max_node() + 1);
+        for (int node = 0; node < static_cast<int>(replicas.size()); node++) {
+            fill(replicas[node], [node](void *data, size_t bytes) {
+                numa_tonode_memory(data, bytes, node);
+            });
+        }
+    } else {
+        replicas.resize(1);
+        fill(replicas[0], [](void *data, size_t bytes) {
+            numa_interleave_memory(data, bytes, numa_all_nodes_ptr);
+        });
+    }
+#endif
+}
+
+// PRIVATE
+template <typename Place>
+void EReplicas::fill(Replica &replica, const Place &place) {
+    replica.words.reserve(e.size() * numInts);
+    replica.signatures.reserve(e.size());
+    // The pages of slabs below a huge page come from malloc and may be shared with other data, they stay where they are
+    if (replica.words.capacity() * sizeof(uint64_t) >= HUGE_PAGE_SIZE) {
+        place(replica.words.data(), replica.words.capacity() * sizeof(uint64_t));
+    }
+    if (replica.signatures.capacity() * sizeof(Signature) >= HUGE_PAGE_SIZE) {
+        place(replica.signatures.data(), replica.signatures.capacity() * sizeof(Signature));
+    }
+    replica.words.resize(e.size() * numInts);
+    replica.signatures.resize(e.size());
+
+    tbb::parallel_for(size_t(0), e.size(), [&](size_t eidx) {
+        const BitRepresentation &combination = e[eidx].getCombination();
+        std::copy(&combination[0], &combination[0] + numInts, replica.words.data() + eidx * numInts);
+        replica.signatures[eidx] = e[eidx].getSignature();
+    });
+}
+
+// ##### Getters/Setters
+EReplicas::View EReplicas::getLocal() const {
+    if (replicas.empty()) {
+        return View(e.data(), nullptr, numInts);
+    }
+    size_t node = ThreadPinning::getCurrentNode();
+    return View(e.data(), &replicas[node < replicas.size() ? node : 0], numInts);
+}
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <stdexcept>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+#include "Algorithms.h"
+#include "PartitionEvaluator.h"
+
+/**
+ * The stamps of one thread. A hyperedge counts for the current CPU if its stamp is not the current one yet.
+ */
+struct Stamps {
+    std::vector<uint32_t> stamps;
+    uint32_t current = 0;
+};
+
+// ##### Getters/Setters
+size_t PartitionQuality::getWorst() const {
+    return repeatClassesOfBlock.empty() ? 0 : *std::max_element(repeatClassesOfBlock.begin(), repeatClassesOfBlock.end());
+}
+
+double PartitionQuality::getAverage() const {
+    size_t sum = 0;
+    for (size_t repeatClasses : repeatClassesOfBlock) {
+        sum += repeatClasses;
+    }
+    return repeatClassesOfBlock.empty() ? 0 : static_cast<double>(sum) / repeatClassesOfBlock.size();
+}
+
+double PartitionQuality::getImbalance() const {
+    double average = getAverage();
+    return average == 0 ? 0 : getWorst() / average - 1;
+}
+
+size_t PartitionQuality::getWorstLowerBound() const {
+    size_t k = repeatClassesOfBlock.size();
+    return k == 0 ? 0 : (totalRepeatClasses + k - 1) / k;
+}
+
+// ##### Constructors
+PartitionEvaluator::PartitionEvaluator(const std::string &repeatsPath, const std::set<uint32_t> &partitionNumbers) {
+    std::map<uint32_t, Hypergraph> hypergraphs = getHypergraphsFromPartitionFile(repeatsPath, partitionNumbers);
+    std::vector<std::pair<const Hypergraph *, Partition *>> toConvert;
+    for (uint32_t partitionNumber : partitionNumbers) {
+        auto hypergraph = hypergraphs.find(partitionNumber);
+        if (hypergraph == hypergraphs.end()) {
+            throw std::runtime_error(repeatsPath + " does not have partition_" + std::to_string(partitionNumber));
+        }
+        toConvert.emplace_back(&hypergraph->second, &partitions[partitionNumber]);
+    }
+
+    tbb::parallel_for(size_t(0), toConvert.size(), [&](size_t i) {
+        const std::vector<hElem> &hyperedges = toConvert[i].first->getHyperEdges();
+        size_t numSites = toConvert[i].first->getHypernodes().size();
+        Partition &partition = *toConvert[i].second;
+        partition.numHyperedges = hyperedges.size();
+
+        partition.offsets.assign(numSites + 1, 0);
+        for (const hElem &hyperedge : hyperedges) {
+            for (uint32_t site : hyperedge) {
+                partition.offsets[site + 1]++;
+            }
+        }
+        for (size_t site = 0; site < numSites; site++) {
+            partition.offsets[site + 1] += partition.offsets[site];
+        }
+        partition.hyperedges.resize(partition.offsets[numSites]);
+        std::vector<uint32_t> positions(partition.offsets.begin(), partition.offsets.end() - 1);
+        for (uint32_t hyperedge = 0; hyperedge < hyperedges.size(); hyperedge++) {
+            for (uint32_t site : hyperedges[hyperedge]) {
+                partition.hyperedges[positions[site]++] = hyperedge;
+            }
+        }
+    });
+}
+
+// ##### Functions
+bool PartitionEvaluator::evaluate(const DataDistribution &distribution, PartitionQuality &quality) const {
+    // Check the assignments first, so the counting below stays within the arrays
+    std::map<uint32_t, std::vector<bool>> covered;
+    for (const std::vector<DataDistribution::Assignment> &block : distribution.blocks) {
+        for (const DataDistribution::Assignment &assignment : block) {
+            auto partition = partitions.find(assignment.partition);
+            if (partition == partitions.end()) {
+                return false;
+            }
+            std::vector<bool> &coveredSites = covered[assignment.partition];
+            coveredSites.resize(partition->second.offsets.size() - 1, false);
+            for (uint32_t site : assignment.sites) {
+                if (site >= coveredSites.size()) {
+                    return false;
+                }
+                coveredSites[site] = true;
+            }
+        }
+    }
+    quality.totalRepeatClasses = 0;
+    for (const auto &coveredSites : covered) {
+        if (std::find(coveredSites.second.begin(), coveredSites.second.end(), false) != coveredSites.second.end()) {
+            return false;
+        }
+        quality.totalRepeatClasses += partitions.at(coveredSites.first).numHyperedges;
+    }
+
+    size_t k = distribution.getK();
+    quality.repeatClassesOfBlock.assign(k, 0);
+    quality.sitesOfBlock.assign(k, 0);
+    tbb::enumerable_thread_specific<Stamps> threadStamps;
+    tbb::parallel_for(size_t(0), k, [&](size_t block) {
+        Stamps &stamps = threadStamps.local();
+        for (const DataDistribution::Assignment &assignment : distribution.blocks[block]) {
+            const Partition &partition = partitions.at(assignment.partition);
+            if (stamps.stamps.size() < partition.numHyperedges) {
+                stamps.stamps.resize(partition.numHyperedges, 0);
+            }
+            if (++stamps.current == 0) {
+                std::fill(stamps.stamps.begin(), stamps.stamps.end(), 0);
+                stamps.current = 1;
+            }
+            size_t repeatClasses = 0;
+            for (uint32_t site : assignment.sites) {
+                for (uint32_t i = partition.offsets[site]; i < partition.offsets[site + 1]; i++) {
+                    uint32_t &stamp = stamps.stamps[partition.hyperedges[i]];
+                    repeatClasses += stamp != stamps.current;
+                    stamp = stamps.current;
+                }
+            }
+            quality.repeatClassesOfBlock[block] += repeatClasses;
+            quality.sitesOfBlock[block] += assignment.sites.size();
+        }
+    });
+    return true;
+}
@@ -0,0 +1,203 @@
+#include <algorithm>
+#include <map>
+#include <numeric>
+#include <tbb/parallel_for.h>
+
+#include "Profiler.h"
+#include "PartitionRefiner.h"
+
+/**
+ * A move of a group out of a block with the maximum load, found against the counters at the start of a pass.
+ */
+struct Move {
+    uint32_t group;
+    uint32_t target;
+    // Hyperedges the source loses and the load of the target afterwards
+    size_t removed;
+    size_t targetLoad;
+};
+
+/**
+ * A block on a hyperedge and the number of its groups on that hyperedge.
+ */
+struct BlockCount {
+    uint32_t block;
+    uint32_t count;
+};
+
+// ##### Constructors
+PartitionRefiner::PartitionRefiner(const Hypergraph &hypergraph) : numHyperedges(hypergraph.getHyperEdges().size()) {
+    size_t numSites = hypergraph.getHypernodes().size();
+    std::vector<std::vector<uint32_t>> hyperedgesOfSite(numSites);
+    const std::vector<hElem> &hyperedges = hypergraph.getHyperEdges();
+    for (uint32_t hyperedge = 0; hyperedge < hyperedges.size(); hyperedge++) {
+        for (uint32_t site : hyperedges[hyperedge]) {
+            hyperedgesOfSite[site].push_back(hyperedge);
+        }
+    }
+
+    std::map<std::vector<uint32_t>, uint32_t> groupOfHyperedges;
+    for (uint32_t site = 0; site < numSites; site++) {
+        auto result = groupOfHyperedges.emplace(hyperedgesOfSite[site], static_cast<uint32_t>(hyperedgesOfGroup.size()));
+        if (result.second) {
+            hyperedgesOfGroup.push_back(std::move(hyperedgesOfSite[site]));
+            sitesOfGroup.emplace_back();
+        }
+        sitesOfGroup[result.first->second].push_back(site);
+    }
+}
+
+// ##### Functions
+void PartitionRefiner::refine(SitePartitioning &partitioning, std::chrono::steady_clock::time_point deadline) const {
+    ScopedPhase phase("refine");
+    size_t k = partitioning.k;
+    std::vector<uint32_t> blockOfGroup(sitesOfGroup.size());
+    std::vector<std::vector<uint32_t>> groupsOfBlock(k);
+    // The blocks on each hyperedge with the number of their groups on it. Most hyperedges are on few blocks, so these
+    // short lists are faster to search than a map per block and take less memory than a counter per block and
+    // hyperedge.
+    std::vector<std::vector<BlockCount>> blocksOnHyperedge(numHyperedges);
+    std::vector<size_t> loads(k, 0);
+    auto countOn = [&blocksOnHyperedge](uint32_t block, uint32_t hyperedge) -> uint32_t {
+        for (const BlockCount &entry : blocksOnHyperedge[hyperedge]) {
+            if (entry.block == block) {
+                return entry.count;
+            }
+        }
+        return 0;
+    };
+    auto addTo = [&](uint32_t group, uint32_t block) {
+        for (uint32_t hyperedge : hyperedgesOfGroup[group]) {
+            std::vector<BlockCount> &entries = blocksOnHyperedge[hyperedge];
+            auto entry = std::find_if(entries.begin(), entries.end(), [block](const BlockCount &entry) {
+                return entry.block == block;
+            });
+            if (entry == entries.end()) {
+                entries.push_back({ block, 1 });
+                loads[block]++;
+            } else {
+                entry->count++;
+            }
+        }
+        blockOfGroup[group] = block;
+        groupsOfBlock[block].push_back(group);
+    };
+    auto removeFrom = [&](uint32_t group, uint32_t block) {
+        for (uint32_t hyperedge : hyperedgesOfGroup[group]) {
+            std::vector<BlockCount> &entries = blocksOnHyperedge[hyperedge];
+            auto entry = std::find_if(entries.begin(), entries.end(), [block](const BlockCount &entry) {
+                return entry.block == block;
+            });
+            if (--entry->count == 0) {
+                *entry = entries.back();
+                entries.pop_back();
+                loads[block]--;
+            }
+        }
+        std::vector<uint32_t> &groups = groupsOfBlock[block];
+        groups.erase(std::find(groups.begin(), groups.end(), group));
+    };
+    auto countRemoved = [&](uint32_t group, uint32_t source) {
+        size_t removed = 0;
+        for (uint32_t hyperedge : hyperedgesOfGroup[group]) {
+            removed += countOn(source, hyperedge) == 1;
+        }
+        return removed;
+    };
+    auto getTargetLoad = [&](uint32_t group, uint32_t target) {
+        size_t targetLoad = loads[target];
+        for (uint32_t hyperedge : hyperedgesOfGroup[group]) {
+            targetLoad += countOn(target, hyperedge) == 0;
+        }
+        return targetLoad;
+    };
+    for (uint32_t group = 0; group < sitesOfGroup.size(); group++) {
+        addTo(group, partitioning.blockOfSite[sitesOfGroup[group][0]]);
+    }
+
+    // Each pass moves groups out of the blocks with the maximum load. Every applied move lowers the load of its source
+    // and leaves the target below the load the source had, so the sorted loads shrink with each move. That ends the
+    // passes eventually, the cap on their number ends them in time.
+    std::vector<uint32_t> blocksByLoad(k);
+    for (size_t pass = 0; pass < sitesOfGroup.size() && std::chrono::steady_clock::now() < deadline; pass++) {
+        std::iota(blocksByLoad.begin(), blocksByLoad.end(), 0);
+        std::sort(blocksByLoad.begin(), blocksByLoad.end(), [&loads](uint32_t lhs, uint32_t rhs) {
+            return loads[lhs] < loads[rhs] || (loads[lhs] == loads[rhs] && lhs < rhs);
+        });
+        size_t maxLoad = loads[blocksByLoad.back()];
+        std::vector<uint32_t> candidates;
+        for (size_t position = k; position-- > 0 && loads[blocksByLoad[position]] == maxLoad;) {
+            uint32_t source = blocksByLoad[position];
+            candidates.insert(candidates.end(), groupsOfBlock[source].begin(), groupsOfBlock[source].end());
+        }
+
+        // Find the best target of each candidate in parallel, the counters are only read. One sweep over the blocks on
+        // the hyperedges of a candidate gives the load of every target after the move. The targets come in the order
+        // of their load, which bounds the load after the move from below.
+        std::vector<Move> moves(candidates.size());
+        tbb::parallel_for(size_t(0), candidates.size(), [&](size_t i) {
+            uint32_t group = candidates[i];
+            uint32_t source = blockOfGroup[group];
+            Move &move = moves[i];
+            move = { group, source, countRemoved(group, source), maxLoad };
+            if (move.removed == 0) {
+                return;
+            }
+            std::vector<uint32_t> shared(k, 0);
+            for (uint32_t hyperedge : hyperedgesOfGroup[group]) {
+                for (const BlockCount &entry : blocksOnHyperedge[hyperedge]) {
+                    shared[entry.block]++;
+                }
+            }
+            for (uint32_t target : blocksByLoad) {
+                if (loads[target] >= move.targetLoad) {
+                    break;
+                }
+                size_t targetLoad = loads[target] + hyperedgesOfGroup[group].size() - shared[target];
+                if (target != source && targetLoad < move.targetLoad) {
+                    move.target = target;
+                    move.targetLoad = targetLoad;
+                }
+            }
+        });
+
+        // Apply the moves with the largest drops first. Earlier moves change the counters, so each one is checked
+        // again against the current loads: it still has to lower the load of its source, and the target has to stay
+        // below the load the source has before the move. This also applies several moves out of the same block.
+        std::sort(moves.begin(), moves.end(), [](const Move &lhs, const Move &rhs) {
+            return lhs.removed > rhs.removed || (lhs.removed == rhs.removed && lhs.group < rhs.group);
+        });
+        size_t numApplied = 0;
+        for (const Move &move : moves) {
+            uint32_t source = blockOfGroup[move.group];
+            if (move.target == source || countRemoved(move.group, source) == 0
+                || getTargetLoad(move.group, move.target) >= loads[source]) {
+                continue;
+            }
+            removeFrom(move.group, source);
+            addTo(move.group, move.target);
+            numApplied++;
+        }
+        if (numApplied == 0) {
+            break;
+        }
+    }
+
+    for (uint32_t group = 0; group < sitesOfGroup.size(); group++) {
+        for (uint32_t site : sitesOfGroup[group]) {
+            partitioning.blockOfSite[site] = blockOfGroup[group];
+        }
+    }
+}
+
+PartitioningConsumer PartitionRefiner::wrap(const PartitionOptions &options, const PartitioningConsumer &consumer) const {
+    return [this, &options, &consumer](const SitePartitioning &partitioning) {
+        SitePartitioning refined = partitioning;
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+        if (options.refinementTime > 0) {
+            deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(options.refinementTime));
+        }
+        refine(refined, deadline);
+        consumer(refined);
+    };
+}
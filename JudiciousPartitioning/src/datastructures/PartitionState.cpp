@@ -0,0 +1,28 @@
+#include "Helper.h"
+#include "PartitionState.h"
+
+// ##### Constructors
+PartitionState::PartitionState(std::istream &stream) {
+    uint64_t round = readUint64(stream);
+    uint64_t isExact = readUint64(stream);
+    uint64_t size = readUint64(stream);
+    d = stream ? round : 0;
+    exact = isExact != 0;
+    // Each element takes at least its number of bits, one word and the size of its covered set
+    fitsInStream(stream, size, 3 * sizeof(uint64_t));
+    for (uint64_t i = 0; stream && i < size; i++) {
+        e.emplace_back(stream);
+    }
+    recorder = MergeHierarchy::Recorder(stream);
+}
+
+// ##### Functions
+void PartitionState::writeTo(std::ostream &stream) const {
+    writeUint64(stream, d);
+    writeUint64(stream, exact ? 1 : 0);
+    writeUint64(stream, e.size());
+    for (const EElem &element : e) {
+        element.writeTo(stream);
+    }
+    recorder.writeTo(stream);
+}
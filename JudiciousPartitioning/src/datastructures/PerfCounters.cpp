@@ -0,0 +1,181 @@
+#include <cstring>
+#include <mutex>
+#include <vector>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "PerfCounters.h"
+
+namespace {
+    const std::array<uint64_t, NUM_PERF_EVENTS> eventConfigs = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+    const std::array<const char *, NUM_PERF_EVENTS> eventNames = {
+            "cycles",
+            "instructions",
+            "cacheMisses",
+            "branchMisses"
+    };
+
+    // The counter group of one thread, the first file descriptor is the group leader
+    using Group = std::array<int, NUM_PERF_EVENTS>;
+
+    // Layout of a read on the leader with PERF_FORMAT_GROUP and both time fields
+    struct GroupReading {
+        uint64_t numEvents;
+        uint64_t timeEnabled;
+        uint64_t timeRunning;
+        uint64_t values[NUM_PERF_EVENTS];
+    };
+
+    struct Registry {
+        std::mutex mutex;
+        // The groups of the threads that are still running
+        std::vector<Group> groups;
+        // The last counts of the groups of threads that have ended, so the sums never go down
+        PerfCounters::Sample retired{};
+    };
+
+    // Never destroyed, as worker threads can end after the static objects are gone
+    Registry &registry = *new Registry;
+    bool enabled = false;
+
+    int openEvent(uint64_t config, int groupFd) {
+        perf_event_attr attributes;
+        memset(&attributes, 0, sizeof(attributes));
+        attributes.size = sizeof(attributes);
+        attributes.type = PERF_TYPE_HARDWARE;
+        attributes.config = config;
+        attributes.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        // Counts the calling thread on any CPU
+        return static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, groupFd, 0));
+    }
+
+    void closeGroup(const Group &group) {
+        for (int fd : group) {
+            if (fd != -1) {
+                close(fd);
+            }
+        }
+    }
+
+    /**
+     * Adds the counts of a group to sum, scaled up if the group only ran on the PMU for part of the time.
+     */
+    void addGroup(const Group &group, PerfCounters::Sample &sum) {
+        GroupReading reading{};
+        if (::read(group[0], &reading, sizeof(reading)) != static_cast<ssize_t>(sizeof(reading)) || reading.timeRunning == 0) {
+            return;
+        }
+        for (size_t event = 0; event < NUM_PERF_EVENTS; event++) {
+            sum[event] += static_cast<uint64_t>(static_cast<double>(reading.values[event]) * reading.timeEnabled / reading.timeRunning);
+        }
+    }
+
+    /**
+     * The group of the calling thread. Its destructor runs when the thread ends, keeps its last counts and closes
+     * its file descriptors.
+     */
+    struct ThreadGroup {
+        Group group;
+
+        ThreadGroup() {
+            group.fill(-1);
+        }
+
+        ~ThreadGroup() {
+            if (group[0] == -1) {
+                return;
+            }
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            addGroup(group, registry.retired);
+            for (auto other = registry.groups.begin(); other != registry.groups.end(); other++) {
+                if ((*other)[0] == group[0]) {
+                    registry.groups.erase(other);
+                    break;
+                }
+            }
+            closeGroup(group);
+        }
+
+        /**
+         * Opens the group.
+         *
+         * @return False if any of the events is not available.
+         */
+        bool open() {
+            for (size_t event = 0; event < NUM_PERF_EVENTS; event++) {
+                group[event] = openEvent(eventConfigs[event], event == 0 ? -1 : group[0]);
+                if (group[event] == -1) {
+                    closeGroup(group);
+                    group.fill(-1);
+                    return false;
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            registry.groups.push_back(group);
+            return true;
+        }
+    };
+
+    thread_local ThreadGroup threadGroup;
+    thread_local bool attached = false;
+}
+
+// ##### Constructors
+PerfCounters::ThreadObserver::ThreadObserver(tbb::task_arena &arena) : tbb::task_scheduler_observer(arena) {
+    observe(true);
+}
+
+PerfCounters::ThreadObserver::~ThreadObserver() {
+    observe(false);
+}
+
+// ##### Functions
+void PerfCounters::ThreadObserver::on_scheduler_entry(bool isWorker) {
+    attachThread();
+}
+
+// ##### Getters/Setters
+const std::array<const char *, NUM_PERF_EVENTS> &PerfCounters::getEventNames() {
+    return eventNames;
+}
+
+bool PerfCounters::isEnabled() {
+    return enabled;
+}
+
+// ##### Functions
+bool PerfCounters::enable() {
+    if (!enabled && threadGroup.open()) {
+        enabled = true;
+        attached = true;
+    }
+    return enabled;
+}
+
+void PerfCounters::attachThread() {
+    if (!enabled || attached) {
+        return;
+    }
+    // A thread without counters is left out of the sums, the others still count
+    attached = threadGroup.open();
+}
+
+PerfCounters::Sample PerfCounters::read() {
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    Sample sum = registry.retired;
+    for (const Group &group : registry.groups) {
+        addGroup(group, sum);
+    }
+    return sum;
+}
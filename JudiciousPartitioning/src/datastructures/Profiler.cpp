@@ -0,0 +1,356 @@
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include "Profiler.h"
+#include "PerfCounters.h"
+#include "MemoryAccounting.h"
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+    struct Record {
+        uint64_t nanoseconds = 0;
+        uint64_t calls = 0;
+        // When the path was first started on any thread, orders the dump like the run
+        uint64_t order = 0;
+        // Allocations of all threads while the phase ran
+        uint64_t allocations = 0;
+        // Highest live heap bytes while the phase ran, only measured for phases of the first thread
+        bool hasPeak = false;
+        int64_t peakLiveBytes = 0;
+        // Hardware events of all threads while the phase ran, if PerfCounters are enabled
+        bool hasCounters = false;
+        PerfCounters::Sample counters{};
+    };
+
+    struct RunningPhase {
+        std::string name;
+        std::string path;
+        Clock::time_point start;
+        uint64_t order;
+        PerfCounters::Sample startCounters;
+        uint64_t startAllocations;
+        int peakSlot;
+    };
+
+    struct ThreadProfile {
+        size_t index;
+        std::mutex mutex;
+        std::vector<RunningPhase> running;
+        // For each detached task the thread runs, the number of phases that ran below it, innermost last
+        std::vector<size_t> detachedAt;
+        std::map<std::string, Record> records;
+    };
+
+    // The number of running phases of the task the thread runs at the moment, the ones below it belong to the tasks
+    // it was taken from
+    size_t getTaskBegin(const ThreadProfile &profile) {
+        return profile.detachedAt.empty() ? 0 : profile.detachedAt.back();
+    }
+
+    // One row of the dump
+    struct Row {
+        std::string path;
+        std::string thread;
+        Record record;
+    };
+
+    std::mutex registryMutex;
+    // Profiles stay alive after their threads end, so the dump still sees them
+    std::vector<std::unique_ptr<ThreadProfile>> threadProfiles;
+    std::atomic<uint64_t> nextOrder{0};
+    thread_local ThreadProfile *currentProfile = nullptr;
+
+    ThreadProfile &getThreadProfile() {
+        if (!currentProfile) {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            threadProfiles.emplace_back(new ThreadProfile());
+            threadProfiles.back()->index = threadProfiles.size() - 1;
+            currentProfile = threadProfiles.back().get();
+        }
+        return *currentProfile;
+    }
+
+    std::vector<Row> collectRows() {
+        std::map<std::string, Row> totals;
+        std::map<std::string, size_t> numThreads;
+        std::vector<Row> rows;
+
+        std::lock_guard<std::mutex> registryLock(registryMutex);
+        for (const auto &profile : threadProfiles) {
+            std::lock_guard<std::mutex> lock(profile->mutex);
+            for (const auto &entry : profile->records) {
+                rows.push_back({ entry.first, std::to_string(profile->index), entry.second });
+
+                Row &total = totals[entry.first];
+                if (numThreads[entry.first]++ == 0) {
+                    total = { entry.first, "all", entry.second };
+                } else {
+                    total.record.nanoseconds += entry.second.nanoseconds;
+                    total.record.calls += entry.second.calls;
+                    total.record.allocations += entry.second.allocations;
+                    total.record.hasPeak |= entry.second.hasPeak;
+                    total.record.peakLiveBytes = std::max(total.record.peakLiveBytes, entry.second.peakLiveBytes);
+                    total.record.hasCounters |= entry.second.hasCounters;
+                    for (size_t event = 0; event < NUM_PERF_EVENTS; event++) {
+                        total.record.counters[event] += entry.second.counters[event];
+                    }
+                    total.record.order = std::min(total.record.order, entry.second.order);
+                }
+            }
+        }
+
+        for (const auto &entry : totals) {
+            if (numThreads[entry.first] > 1) {
+                rows.push_back(entry.second);
+            }
+        }
+
+        // Order of the run, the rows of the same path next to each other and the total last
+        std::stable_sort(rows.begin(), rows.end(), [&totals](const Row &lhs, const Row &rhs) {
+            return totals[lhs.path].record.order < totals[rhs.path].record.order;
+        });
+        return rows;
+    }
+
+    /**
+     * Formats the memory accounting for the summary.
+     */
+    std::string formatMemory(const Record &record) {
+        std::string result = " [";
+        if (record.hasPeak) {
+            result += "peak " + std::to_string(record.peakLiveBytes / 1024 / 1024) + "MB live, ";
+        }
+        return result + std::to_string(record.allocations) + " allocations]";
+    }
+
+    /**
+     * Formats the counters for the summary, with the derived instructions per cycle and memory traffic. The traffic
+     * assumes a full cache line of DRAM transfer per last level cache miss.
+     */
+    std::string formatCounters(const Record &record) {
+        std::string result;
+        for (size_t event = 0; event < NUM_PERF_EVENTS; event++) {
+            result += std::string(event == 0 ? " (" : ", ") + PerfCounters::getEventNames()[event] + " " + std::to_string(record.counters[event]);
+        }
+        if (record.counters[0] != 0) {
+            result += ", IPC " + std::to_string(static_cast<double>(record.counters[1]) / record.counters[0]);
+        }
+        if (record.nanoseconds != 0) {
+            result += ", ~" + std::to_string(record.counters[2] * 64 * 1000 / record.nanoseconds) + "MB/s memory traffic";
+        }
+        return result + ")";
+    }
+
+    std::string escapeJson(const std::string &text) {
+        std::string result;
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                result += '\\';
+            }
+            result += c;
+        }
+        return result;
+    }
+}
+
+// ##### Functions
+void Profiler::start(const std::string &name) {
+    ThreadProfile &profile = getThreadProfile();
+    std::lock_guard<std::mutex> lock(profile.mutex);
+    size_t taskBegin = getTaskBegin(profile);
+    for (size_t i = taskBegin; i < profile.running.size(); i++) {
+        if (profile.running[i].name == name) {
+            throw std::logic_error("The timer '" + name + "' is already running!");
+        }
+    }
+
+    std::string path = profile.running.size() == taskBegin ? name : profile.running.back().path + "/" + name;
+    PerfCounters::Sample startCounters{};
+    if (PerfCounters::isEnabled()) {
+        startCounters = PerfCounters::read();
+    }
+    // Only the phases of the main thread, which registers first, measure a high-water mark. The live bytes belong to
+    // the whole process anyway, and the marks of the nested phases of all workers would exceed the slots.
+    int peakSlot = profile.index == 0 ? MemoryAccounting::beginPeak() : -1;
+    uint64_t startAllocations = MemoryAccounting::getNumAllocations();
+    profile.running.push_back({ name, std::move(path), Clock::now(), nextOrder++, startCounters, startAllocations, peakSlot });
+}
+
+void Profiler::stop(const std::string &name) {
+    Clock::time_point end = Clock::now();
+    uint64_t endAllocations = MemoryAccounting::getNumAllocations();
+    PerfCounters::Sample endCounters{};
+    if (PerfCounters::isEnabled()) {
+        endCounters = PerfCounters::read();
+    }
+    ThreadProfile &profile = getThreadProfile();
+    std::lock_guard<std::mutex> lock(profile.mutex);
+    if (profile.running.size() == getTaskBegin(profile) || profile.running.back().name != name) {
+        throw std::logic_error("The timer '" + name + "' isn't the innermost running timer!");
+    }
+
+    RunningPhase &phase = profile.running.back();
+    auto inserted = profile.records.emplace(phase.path, Record());
+    Record &record = inserted.first->second;
+    if (inserted.second) {
+        record.order = phase.order;
+    }
+    record.nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(end - phase.start).count();
+    record.calls++;
+    record.allocations += endAllocations - phase.startAllocations;
+    if (profile.index == 0) {
+        record.hasPeak = true;
+        record.peakLiveBytes = std::max(record.peakLiveBytes, MemoryAccounting::endPeak(phase.peakSlot));
+    }
+    if (PerfCounters::isEnabled()) {
+        record.hasCounters = true;
+        for (size_t event = 0; event < NUM_PERF_EVENTS; event++) {
+            record.counters[event] += endCounters[event] - phase.startCounters[event];
+        }
+    }
+    profile.running.pop_back();
+}
+
+bool Profiler::stopNoThrow(const std::string &name) noexcept {
+    try {
+        stop(name);
+        return true;
+    } catch (const std::exception &error) {
+        std::cerr << "Profiler: " << error.what() << std::endl;
+        assert(false && "Could not stop a scoped phase");
+        return false;
+    }
+}
+
+void Profiler::detach() {
+    ThreadProfile &profile = getThreadProfile();
+    std::lock_guard<std::mutex> lock(profile.mutex);
+    profile.detachedAt.push_back(profile.running.size());
+}
+
+void Profiler::attach() {
+    ThreadProfile &profile = getThreadProfile();
+    std::lock_guard<std::mutex> lock(profile.mutex);
+    assert(!profile.detachedAt.empty() && profile.running.size() == profile.detachedAt.back());
+    profile.detachedAt.pop_back();
+}
+
+void Profiler::printSummary(std::ostream &stream, const std::string &mainPhase, std::ostream &mainStream) {
+    {
+        ThreadProfile &profile = getThreadProfile();
+        std::lock_guard<std::mutex> lock(profile.mutex);
+        if (!profile.running.empty()) {
+            throw std::logic_error("There is still a timer running: " + profile.running.back().name);
+        }
+    }
+
+    // The top level phases summed over all threads, in the order of the run
+    std::vector<Row> totals;
+    for (const Row &row : collectRows()) {
+        if (row.path.find('/') != std::string::npos) {
+            continue;
+        }
+        if (totals.empty() || totals.back().path != row.path) {
+            totals.push_back(row);
+        } else {
+            // The total over several threads comes last and replaces the per thread rows
+            totals.back() = row;
+        }
+    }
+
+    for (const Row &row : totals) {
+        std::ostream &rowStream = row.path == mainPhase ? mainStream : stream;
+        if (row.record.nanoseconds < 10'000'000) {
+            rowStream << row.path << ": " << row.record.nanoseconds / 1000 << "µs";
+        } else {
+            rowStream << row.path << ": " << row.record.nanoseconds / 1000 / 1000 << "ms";
+        }
+        rowStream << formatMemory(row.record) << (row.record.hasCounters ? formatCounters(row.record) : "") << std::endl;
+    }
+}
+
+void Profiler::writeJson(std::ostream &stream) {
+    stream << "{\"phases\": [";
+    bool first = true;
+    for (const Row &row : collectRows()) {
+        stream << (first ? "\n" : ",\n")
+               << "  {\"path\": \"" << escapeJson(row.path) << "\", \"thread\": \"" << row.thread
+               << "\", \"calls\": " << row.record.calls << ", \"nanoseconds\": " << row.record.nanoseconds
+               << ", \"allocations\": " << row.record.allocations;
+        if (row.record.hasPeak) {
+            stream << ", \"peakLiveBytes\": " << row.record.peakLiveBytes;
+        }
+        for (size_t event = 0; row.record.hasCounters && event < NUM_PERF_EVENTS; event++) {
+            stream << ", \"" << PerfCounters::getEventNames()[event] << "\": " << row.record.counters[event];
+        }
+        stream << "}";
+        first = false;
+    }
+    stream << "\n]}" << std::endl;
+}
+
+void Profiler::writeCsv(std::ostream &stream) {
+    // The counter columns are always there and stay empty without counters
+    stream << "path,thread,calls,nanoseconds,allocations,peakLiveBytes";
+    for (const char *eventName : PerfCounters::getEventNames()) {
+        stream << ',' << eventName;
+    }
+    stream << '\n';
+    for (const Row &row : collectRows()) {
+        stream << '"' << row.path << "\"," << row.thread << ',' << row.record.calls << ',' << row.record.nanoseconds
+               << ',' << row.record.allocations << ',';
+        if (row.record.hasPeak) {
+            stream << row.record.peakLiveBytes;
+        }
+        for (uint64_t count : row.record.counters) {
+            stream << ',';
+            if (row.record.hasCounters) {
+                stream << count;
+            }
+        }
+        stream << '\n';
+    }
+    stream.flush();
+}
+
+bool Profiler::dump(const std::string &path) {
+    std::ofstream file(path);
+    if (!file) {
+        return false;
+    }
+    if (path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0) {
+        writeCsv(file);
+    } else {
+        writeJson(file);
+    }
+    return static_cast<bool>(file);
+}
+
+// ##### Constructors
+ScopedPhase::ScopedPhase(std::string name) : name(std::move(name)) {
+    Profiler::start(this->name);
+}
+
+ScopedPhase::~ScopedPhase() {
+    // Throwing here would terminate the program, also while an exception unwinds through the phase
+    Profiler::stopNoThrow(name);
+}
+
+// ##### Constructors
+DetachedPhases::DetachedPhases() {
+    Profiler::detach();
+}
+
+DetachedPhases::~DetachedPhases() {
+    Profiler::attach();
+}
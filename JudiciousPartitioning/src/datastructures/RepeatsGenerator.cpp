@@ -0,0 +1,88 @@
+#include <algorithm>
+#include <cassert>
+#include <random>
+
+#include "RepeatsGenerator.h"
+
+bool parseRepeatClassDistribution(const std::string &name, RepeatClassDistribution &distribution) {
+    if (name == "uniform") {
+        distribution = RepeatClassDistribution::UNIFORM;
+    } else if (name == "zipf") {
+        distribution = RepeatClassDistribution::ZIPF;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// ##### Constructors
+RepeatsGenerator::RepeatsGenerator(size_t numSites, size_t numRows, size_t numRepeatClasses,
+                                   RepeatClassDistribution distribution, double duplicateSiteRatio, uint64_t seed) :
+        numSites(numSites),
+        numRows(numRows),
+        numRepeatClasses(std::max<size_t>(numRepeatClasses, 1)),
+        distribution(distribution),
+        duplicateSiteRatio(duplicateSiteRatio),
+        seed(seed) {
+}
+
+// ##### Functions
+std::vector<std::vector<uint32_t>> RepeatsGenerator::generateRows() const {
+    std::mt19937_64 generator(seed);
+
+    std::vector<double> weights(numRepeatClasses, 1.0);
+    if (distribution == RepeatClassDistribution::ZIPF) {
+        for (size_t i = 0; i < numRepeatClasses; i++) {
+            weights[i] = 1.0 / (i + 1);
+        }
+    }
+    std::discrete_distribution<uint32_t> repeatClass(weights.begin(), weights.end());
+    std::bernoulli_distribution isDuplicate(duplicateSiteRatio);
+
+    // Draw the sites column by column, so a duplicate can copy a whole earlier column
+    std::vector<std::vector<uint32_t>> rows(numRows, std::vector<uint32_t>(numSites));
+    for (size_t site = 0; site < numSites; site++) {
+        if (site > 0 && isDuplicate(generator)) {
+            size_t original = std::uniform_int_distribution<size_t>(0, site - 1)(generator);
+            for (std::vector<uint32_t> &row : rows) {
+                row[site] = row[original];
+            }
+        } else {
+            for (std::vector<uint32_t> &row : rows) {
+                row[site] = repeatClass(generator);
+            }
+        }
+    }
+
+    // Renumber the classes of each row by their first site, which also closes the gaps of unused classes
+    std::vector<uint32_t> renumbered(numRepeatClasses);
+    for (std::vector<uint32_t> &row : rows) {
+        std::fill(renumbered.begin(), renumbered.end(), UINT32_MAX);
+        uint32_t nextClass = 0;
+        for (uint32_t &siteClass : row) {
+            if (renumbered[siteClass] == UINT32_MAX) {
+                renumbered[siteClass] = nextClass++;
+            }
+            siteClass = renumbered[siteClass];
+        }
+        assert(nextClass <= numSites);
+    }
+
+    return rows;
+}
+
+Hypergraph RepeatsGenerator::generateHypergraph() const {
+    return Hypergraph::fromRepeatClasses(generateRows());
+}
+
+void RepeatsGenerator::writeTo(std::ostream &stream) const {
+    std::vector<std::vector<uint32_t>> rows = generateRows();
+    stream << "1 " << numRows << "\n";
+    stream << "partition_0 " << numSites << "\n";
+    for (const std::vector<uint32_t> &row : rows) {
+        for (uint32_t siteClass : row) {
+            stream << siteClass << " ";
+        }
+        stream << "\n";
+    }
+}
@@ -0,0 +1,156 @@
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include <unistd.h>
+
+#include <sys/stat.h>
+
+#include "Algorithms.h"
+#include "Helper.h"
+#include "ResultCache.h"
+
+// Marks the files of store, "JPRC" in little endian
+static const uint32_t magic = 0x4352504A;
+// Changes with the format of the files
+static const uint32_t version = 3;
+
+// FNV-1a, folding in 32 bit values
+static void hashValue(uint64_t &hash, uint32_t value) {
+    for (int byte = 0; byte < 4; byte++) {
+        hash ^= (value >> (8 * byte)) & 0xFF;
+        hash *= 0x100000001B3;
+    }
+}
+
+// The dimensions of a hypergraph and a second hash of it, independent of the key, to tell apart hypergraphs whose keys
+// collide
+struct Fingerprint {
+    uint64_t numSites;
+    uint64_t numHyperedges;
+    uint64_t numPins;
+    uint64_t check;
+
+    bool operator==(const Fingerprint &rhs) const {
+        return numSites == rhs.numSites && numHyperedges == rhs.numHyperedges && numPins == rhs.numPins && check == rhs.check;
+    }
+
+    void writeTo(std::ostream &stream) const {
+        writeUint64(stream, numSites);
+        writeUint64(stream, numHyperedges);
+        writeUint64(stream, numPins);
+        writeUint64(stream, check);
+    }
+
+    static Fingerprint readFrom(std::istream &stream) {
+        Fingerprint fingerprint;
+        fingerprint.numSites = readUint64(stream);
+        fingerprint.numHyperedges = readUint64(stream);
+        fingerprint.numPins = readUint64(stream);
+        fingerprint.check = readUint64(stream);
+        return fingerprint;
+    }
+};
+
+static Fingerprint getFingerprint(const Hypergraph &hypergraph) {
+    Fingerprint fingerprint = { hypergraph.getHypernodes().size(), hypergraph.getHyperEdges().size(), 0, 0 };
+    // Multiply and xorshift, unrelated to the FNV-1a of the key
+    auto mix = [&fingerprint](uint64_t value) {
+        fingerprint.check = (fingerprint.check ^ value) * 0xFF51AFD7ED558CCD;
+        fingerprint.check ^= fingerprint.check >> 33;
+    };
+    for (const hElem &hyperedge : hypergraph.getHyperEdges()) {
+        fingerprint.numPins += hyperedge.size();
+        mix(~static_cast<uint64_t>(hyperedge.size()));
+        for (uint32_t hypernode : hyperedge) {
+            mix(hypernode);
+        }
+    }
+    return fingerprint;
+}
+
+// ##### Constructors
+ResultCache::ResultCache(const std::string &directory, bool localityReordering)
+        : directory(directory), localityReordering(localityReordering) {
+    struct stat status;
+    if (mkdir(directory.c_str(), 0755) != 0 && (errno != EEXIST || stat(directory.c_str(), &status) != 0 || !S_ISDIR(status.st_mode))) {
+        throw std::runtime_error("Could not create the cache directory " + directory);
+    }
+}
+
+// ##### Functions
+std::string ResultCache::getPath(uint64_t key) const {
+    char name[24];
+    snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(key));
+    return directory + "/" + name + ".cache";
+}
+
+uint64_t ResultCache::getKey(const Hypergraph &hypergraph, bool localityReordering) {
+    uint64_t hash = 0xCBF29CE484222325;
+
+    // The build and the reordering decide the rounds, the build also the format of the stored elements
+    uint32_t flavor = version << 8;
+    flavor |= std::is_same<BitRepresentation, SparseBitVector>::value ? 1 : 0;
+#ifdef DETERMINISM
+    flavor |= 2;
+#endif
+#ifdef FAKE_DETECTION
+    flavor |= 4;
+#endif
+    flavor |= localityReordering ? 8 : 0;
+    hashValue(hash, flavor);
+
+    hashValue(hash, static_cast<uint32_t>(hypergraph.getHypernodes().size()));
+    for (const hElem &hyperedge : hypergraph.getHyperEdges()) {
+        hashValue(hash, static_cast<uint32_t>(hyperedge.size()));
+        for (uint32_t hypernode : hyperedge) {
+            hashValue(hash, hypernode);
+        }
+    }
+    return hash;
+}
+
+bool ResultCache::load(const Hypergraph &hypergraph, PartitionState &state) const {
+    uint64_t key = getKey(hypergraph, localityReordering);
+    Fingerprint fingerprint = getFingerprint(hypergraph);
+    size_t numSites = hypergraph.getHypernodes().size();
+    std::ifstream file(getPath(key), std::ios::binary);
+    uint32_t fileMagic = 0;
+    readArray(file, &fileMagic, 1);
+    uint64_t fileKey = readUint64(file);
+    Fingerprint fileFingerprint = Fingerprint::readFrom(file);
+    if (!file || fileMagic != magic || fileKey != key || !(fileFingerprint == fingerprint)) {
+        return false;
+    }
+
+    PartitionState loaded(file);
+    if (!file || loaded.d == 0 || loaded.e.empty() || loaded.recorder.getNumRounds() != loaded.d || loaded.recorder.getNumSites() != numSites) {
+        return false;
+    }
+    state = std::move(loaded);
+    return true;
+}
+
+bool ResultCache::store(const Hypergraph &hypergraph, const PartitionState &state) const {
+    if (!state.exact) {
+        return true;
+    }
+    uint64_t key = getKey(hypergraph, localityReordering);
+    Fingerprint fingerprint = getFingerprint(hypergraph);
+    std::string path = getPath(key);
+    std::string temporaryPath = path + "." + std::to_string(getpid());
+    {
+        std::ofstream file(temporaryPath, std::ios::binary);
+        writeArray(file, &magic, 1);
+        writeUint64(file, key);
+        fingerprint.writeTo(file);
+        state.writeTo(file);
+        file.close();
+        if (!file) {
+            std::remove(temporaryPath.c_str());
+            return false;
+        }
+    }
+    return std::rename(temporaryPath.c_str(), path.c_str()) == 0;
+}
@@ -1,18 +1,36 @@
 #include "SElem.h"
+#include "Helper.h"
 
 // ##### Constructors
 SElem::SElem(BitRepresentation &&combination,
         uint32_t leftElementIdx,
         uint32_t rightElementIdx,
         const std::set<uint32_t> &left,
-        const std::set<uint32_t> &right) noexcept : combination(std::move(combination)), coveredEElems({ leftElementIdx, rightElementIdx }) {
+        const std::set<uint32_t> &right) noexcept :
+        combination(std::move(combination)),
+        combinationHash(this->combination.hash()),
+        coveredEElems({ leftElementIdx, rightElementIdx }) {
     coveredE0Elems.insert(left.begin(), left.end());
     coveredE0Elems.insert(right.begin(), right.end());
 }
 
+SElem::SElem(BitRepresentation &&combination, std::set<uint32_t> coveredEElems, std::set<uint32_t> coveredE0Elems) :
+        combination(std::move(combination)),
+        combinationHash(this->combination.hash()),
+        coveredEElems(std::move(coveredEElems)),
+        coveredE0Elems(std::move(coveredE0Elems)) {
+}
+
+SElem::SElem(std::istream &stream) :
+        combination(stream),
+        combinationHash(combination.hash()),
+        coveredEElems(readIndexSet(stream)),
+        coveredE0Elems(readIndexSet(stream)) {
+}
+
 // ##### Operators
 bool SElem::operator==(const SElem &rhs) const {
-    return this->combination == rhs.combination;
+    return this->combinationHash == rhs.combinationHash && this->combination == rhs.combination;
 }
 
 bool SElem::operator!=(const SElem &rhs) const {
@@ -64,6 +82,15 @@ std::set<uint32_t> &SElem::getCoveredE0Elems() {
     return coveredE0Elems;
 }
 
+uint64_t SElem::getHash() const {
+    return combinationHash;
+}
+
+size_t SElem::getMemoryUsage() const {
+    return sizeof(SElem) - sizeof(BitRepresentation) + combination.getMemoryUsage()
+           + (coveredEElems.size() + coveredE0Elems.size()) * SET_NODE_BYTES;
+}
+
 // ##### Functions
 bool SElem::covers(const SElem &rhs) const {
     return combination.covers(rhs.combination);
@@ -75,4 +102,10 @@ bool SElem::covers(const BitRepresentation &rhs) const {
 
 size_t SElem::countOnes() const {
     return combination.countOnes();
-}
\ No newline at end of file
+}
+
+void SElem::writeTo(std::ostream &stream) const {
+    combination.writeTo(stream);
+    writeIndexSet(stream, coveredEElems);
+    writeIndexSet(stream, coveredE0Elems);
+}
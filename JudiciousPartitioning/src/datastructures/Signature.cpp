@@ -0,0 +1,48 @@
+#include "Signature.h"
+
+// ##### Constructors
+Signature::Signature(const AlignedBitArray &combination) {
+    for (size_t i = 0; i < combination.getNumInts(); i++) {
+        words[i % SIGNATURE_WORDS] ^= combination[i];
+    }
+}
+
+Signature::Signature(const SparseBitVector &combination) {
+    for (uint32_t bit : combination.getBitarray()) {
+        words[(bit / 64) % SIGNATURE_WORDS] ^= 1UL << bit % 64;
+    }
+}
+
+// ##### Operators
+Signature Signature::operator|(const Signature &rhs) const {
+    Signature result;
+    for (size_t i = 0; i < SIGNATURE_WORDS; i++) {
+        result.words[i] = words[i] | rhs.words[i];
+    }
+    return result;
+}
+
+Signature Signature::operator&(const Signature &rhs) const {
+    Signature result;
+    for (size_t i = 0; i < SIGNATURE_WORDS; i++) {
+        result.words[i] = words[i] & rhs.words[i];
+    }
+    return result;
+}
+
+// ##### Functions
+size_t Signature::distanceLowerBound(const Signature &rhs) const {
+    size_t result = 0;
+    for (size_t i = 0; i < SIGNATURE_WORDS; i++) {
+        result += __builtin_popcountll(words[i] ^ rhs.words[i]);
+    }
+    return result;
+}
+
+size_t Signature::distanceLowerBound(const Signature &groupOr, const Signature &groupAnd) const {
+    size_t result = 0;
+    for (size_t i = 0; i < SIGNATURE_WORDS; i++) {
+        result += __builtin_popcountll((words[i] & ~groupOr.words[i]) | (~words[i] & groupAnd.words[i]));
+    }
+    return result;
+}
@@ -0,0 +1,10 @@
+#include "SitePartitioning.h"
+
+// ##### Functions
+std::vector<std::vector<size_t>> SitePartitioning::getBlocks() const {
+    std::vector<std::vector<size_t>> blocks(k);
+    for (size_t site = 0; site < blockOfSite.size(); site++) {
+        blocks[blockOfSite[site]].push_back(site);
+    }
+    return blocks;
+}
@@ -2,11 +2,22 @@
 #include <SparseBitVector.h>
 
 #include "SparseBitVector.h"
+#include "Helper.h"
 
 // ##### Constructors
 SparseBitVector::SparseBitVector(size_t numBits) : numBits(numBits) {
 }
 
+SparseBitVector::SparseBitVector(std::istream &stream) {
+    uint64_t bits = readUint64(stream);
+    uint64_t size = readUint64(stream);
+    if (fitsInStream(stream, size, sizeof(uint32_t))) {
+        numBits = bits;
+        bitarray.resize(size);
+        readArray(stream, bitarray.data(), bitarray.size());
+    }
+}
+
 SparseBitVector::SparseBitVector(const SparseBitVector &other) = default;
 
 SparseBitVector::SparseBitVector(SparseBitVector &&other) noexcept : numBits(other.numBits), bitarray(std::move(other.bitarray)) {
@@ -123,6 +134,10 @@ const std::vector<uint32_t> &SparseBitVector::getBitarray() const {
     return bitarray;
 }
 
+size_t SparseBitVector::getMemoryUsage() const {
+    return sizeof(SparseBitVector) + sizeof(uint32_t) * bitarray.capacity();
+}
+
 void SparseBitVector::setBit(size_t i) {
     assert(i < numBits);
     bitarray.insert(std::upper_bound(bitarray.begin(), bitarray.end(), i), static_cast<uint32_t>(i));
@@ -202,3 +217,41 @@ void SparseBitVector::setRightmost(const SparseBitVector &rhs) {
         setBit(rhs.bitarray[j]);
     }
 }
+
+uint64_t SparseBitVector::hash() const {
+    const uint64_t prime = 0x9E3779B97F4A7C15;
+    uint64_t result = numBits;
+    for (uint32_t index : bitarray) {
+        uint64_t mixed = result ^ index;
+        result = ((mixed << 31) | (mixed >> 33)) * prime;
+    }
+    result ^= result >> 32;
+    return result;
+}
+
+void SparseBitVector::writeTo(std::ostream &stream) const {
+    writeUint64(stream, numBits);
+    writeUint64(stream, bitarray.size());
+    writeArray(stream, bitarray.data(), bitarray.size());
+}
+
+bool SparseBitVector::grayCodeLess(const SparseBitVector &rhs) const {
+    assert(numBits == rhs.numBits);
+    // Walk from the most significant bit down, counting the ones both vectors share
+    size_t parity = 0;
+    auto i = bitarray.rbegin();
+    auto j = rhs.bitarray.rbegin();
+    for (; i != bitarray.rend() && j != rhs.bitarray.rend(); i++, j++, parity++) {
+        if (*i != *j) {
+            // The vector with the higher set bit has a one where the other has a zero
+            bool hasBit = *i > *j;
+            return parity % 2 == 0 ? !hasBit : hasBit;
+        }
+    }
+
+    if (i == bitarray.rend() && j == rhs.bitarray.rend()) {
+        return false;
+    }
+    bool hasBit = i != bitarray.rend();
+    return parity % 2 == 0 ? !hasBit : hasBit;
+}
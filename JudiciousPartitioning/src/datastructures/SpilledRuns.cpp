@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <queue>
+#include <stdexcept>
+#include <unistd.h>
+
+#include "SpilledRuns.h"
+
+// ##### Constructors
+SpilledRuns::SpilledRuns(std::string directory) : directory(std::move(directory)) {
+}
+
+// ##### Getters/Setters
+bool SpilledRuns::empty() const {
+    return runs.empty();
+}
+
+size_t SpilledRuns::size() const {
+    return runs.size();
+}
+
+// ##### Functions
+void SpilledRuns::spill(std::vector<SElem> &&run) {
+    std::sort(run.begin(), run.end(), [](const SElem &lhs, const SElem &rhs) {
+        return lhs.getCombination() < rhs.getCombination();
+    });
+
+    std::string path = directory + "/JudiciousPartitioning-run-XXXXXX";
+    int fd = mkstemp(&path[0]);
+    if (fd == -1) {
+        throw std::runtime_error("Could not create a spill file in " + directory);
+    }
+    close(fd);
+
+    std::unique_ptr<std::fstream> file(new std::fstream(path, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc));
+    // The open stream keeps the file alive, so nothing is left behind if the process gets killed
+    unlink(path.c_str());
+
+    uint64_t numElements = run.size();
+    file->write(reinterpret_cast<const char *>(&numElements), sizeof(numElements));
+    for (const SElem &currentS : run) {
+        currentS.writeTo(*file);
+    }
+    file->flush();
+
+    if (!*file) {
+        throw std::runtime_error("Could not write a spill file in " + directory);
+    }
+    run.clear();
+    runs.push_back(std::move(file));
+}
+
+std::vector<SElem> SpilledRuns::merge(std::vector<SElem> &&remaining) {
+    std::sort(remaining.begin(), remaining.end(), [](const SElem &lhs, const SElem &rhs) {
+        return lhs.getCombination() < rhs.getCombination();
+    });
+
+    // The next unmerged element of each run and how many are left in the run. The in memory elements are the last run.
+    std::vector<SElem> heads(runs.size() + 1);
+    std::vector<uint64_t> numLeft(runs.size() + 1, 0);
+    auto comesLater = [&heads](size_t lhs, size_t rhs) {
+        return heads[rhs].getCombination() < heads[lhs].getCombination();
+    };
+    std::priority_queue<size_t, std::vector<size_t>, decltype(comesLater)> queue(comesLater);
+
+    const size_t inMemory = runs.size();
+    auto advance = [&](size_t run) {
+        if (numLeft[run] == 0) {
+            return;
+        }
+        numLeft[run]--;
+        if (run == inMemory) {
+            heads[run] = std::move(remaining[remaining.size() - numLeft[run] - 1]);
+        } else {
+            heads[run] = SElem(*runs[run]);
+            if (!*runs[run]) {
+                throw std::runtime_error("Could not read a spill file in " + directory);
+            }
+        }
+        queue.push(run);
+    };
+
+    for (size_t run = 0; run < runs.size(); run++) {
+        runs[run]->seekg(0);
+        runs[run]->read(reinterpret_cast<char *>(&numLeft[run]), sizeof(uint64_t));
+        advance(run);
+    }
+    numLeft[inMemory] = remaining.size();
+    advance(inMemory);
+
+    std::vector<SElem> result;
+    while (!queue.empty()) {
+        size_t run = queue.top();
+        queue.pop();
+
+        if (!result.empty() && result.back().getCombination() == heads[run].getCombination()) {
+            SElem &merged = result.back();
+            merged.getCoveredEElems().insert(heads[run].getCoveredEElems().begin(), heads[run].getCoveredEElems().end());
+            merged.getCoveredE0Elems().insert(heads[run].getCoveredE0Elems().begin(), heads[run].getCoveredE0Elems().end());
+        } else {
+            result.push_back(std::move(heads[run]));
+        }
+        advance(run);
+    }
+
+    runs.clear();
+    remaining.clear();
+    return result;
+}
@@ -0,0 +1,46 @@
+#include <stdexcept>
+#include <sys/resource.h>
+
+#include "Telemetry.h"
+
+// ##### Constructors
+TelemetryWriter::TelemetryWriter(const std::string &path) : file(path) {
+    if (!file) {
+        throw std::runtime_error("Could not create the telemetry file " + path);
+    }
+}
+
+// ##### Functions
+void TelemetryWriter::write(const RoundStatistics &statistics) {
+    file << "{\"d\": " << statistics.d
+         << ", \"cmPlusD\": " << statistics.cmPlusD
+         << ", \"sizeE\": " << statistics.sizeE
+         << ", \"sizeS\": " << statistics.sizeS
+         << ", \"sizeSStar\": " << statistics.sizeSStar
+         << ", \"distanceTwoPairs\": " << statistics.numDistanceTwoPairs
+         << ", \"fillUps\": " << statistics.numFillUps
+         << ", \"spilledRuns\": " << statistics.numSpilledRuns
+         << ", \"generateSNanoseconds\": " << statistics.generateSNanoseconds
+         << ", \"findMinimalSubsetNanoseconds\": " << statistics.findMinimalSubsetNanoseconds
+         << ", \"roundNanoseconds\": " << statistics.roundNanoseconds
+         << ", \"peakResidentBytes\": " << statistics.peakResidentBytes
+         << ", \"peakLiveBytes\": " << statistics.peakLiveBytes
+         << ", \"allocations\": " << statistics.numAllocations
+         << ", \"bytesE\": " << statistics.bytesE
+         << ", \"bytesCoveredE0Elems\": " << statistics.bytesCoveredE0Elems
+         << ", \"bytesS\": " << statistics.bytesS
+         << ", \"bytesMinimalDistances\": " << statistics.bytesMinimalDistances
+         << ", \"approximate\": " << (statistics.approximate ? "true" : "false")
+         << ", \"ks\": [";
+    for (size_t i = 0; i < statistics.ks.size(); i++) {
+        file << (i == 0 ? "" : ", ") << statistics.ks[i];
+    }
+    file << "]}" << std::endl;
+}
+
+size_t TelemetryWriter::getPeakResidentBytes() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    // Linux reports kilobytes
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;
+}
@@ -1,52 +1,208 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
 #include <fstream>
+#include <memory>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 #include <vector>
 #include <set>
 
+#include <getopt.h>
 #include <sys/stat.h>
 
-#include <boost/algorithm/string/classification.hpp>
-#include <boost/algorithm/string/split.hpp>
-#include <boost/algorithm/string.hpp>
-
 #include "Hypergraph.h"
 #include "Algorithms.h"
+#include "JudiciousPartitioner.h"
+#include "MergeHierarchy.h"
+#include "DDFWriter.h"
+#include "ResultCache.h"
+#include "Checkpoint.h"
 #include "Helper.h"
+#include "Distributed.h"
+#include "Profiler.h"
+#include "PerfCounters.h"
 
 
-/**
- * Extract a set of k's from the string that is input on the command line.
- * E.g., get {2, 4, 8} from "2,4,8"
- */
-std::set<size_t> getKSetFromKString(std::string kString) {
-    std::set<size_t> kSet;
-
-    if (boost::contains(kString, ",")) {  // Input contains multiple elements
-        std::vector<std::string> splitKString;
-        boost::split(splitKString, kString, boost::is_any_of(","));
-
-        for (const auto &s : splitKString) {
-            size_t cur;
-            std::stringstream str(s);
-            str >> cur;
-            kSet.insert(cur);
-        }
-    } else {  // Input contains only one element
-        size_t k;
-        std::stringstream str(kString);
-        str >> k;
-        kSet.insert(k);
-    }
-
-    return kSet;
+void printUsage(const char *program) {
+    std::cout << "Usage: " << program << " [options] partition_file k1[,k2[,k3...]] [partition_number]" << std::endl
+              << "Options:" << std::endl
+              << "  --memory-budget MB  Limit the memory for the set S while generateS builds it, spill sorted runs to disk above it" << std::endl
+              << "  --spill-dir DIR     Directory for the spilled runs (default: /tmp)" << std::endl
+              << "  --threads N         Number of threads (default: one per core)" << std::endl
+              << "  --numa MODE         Placement of E on NUMA nodes: off, replicate or interleave (default: off)" << std::endl
+              << "  --cpus LIST         Pin the threads to these comma separated cores, the first thread to the first core" << std::endl
+              << "  --profile FILE      Write the time of each phase and round to FILE, as CSV if it ends in .csv, else JSON" << std::endl
+              << "  --perf-counters     Also count cycles, instructions, cache and branch misses of each phase" << std::endl
+              << "  --telemetry FILE    Write the sizes, times and peak memory of each round to FILE as JSON lines" << std::endl
+              << "  --hierarchy FILE    Write the blocks of all rounds down to the smallest k to FILE instead of printing" << std::endl
+              << "                      the partitions, extractPartitions prints them for any k from it" << std::endl
+              << "  --output-dir DIR    Write the partitions for each k to DIR/<k>.ddf instead of printing them" << std::endl
+              << "  --output-container FILE  Write the partitions for all ks to FILE with an index at the end" << std::endl
+              << "  --cache DIR         Reuse the rounds of earlier runs of the same partition stored in DIR and store" << std::endl
+              << "                      the rounds of this run there" << std::endl
+              << "  --checkpoint FILE   Write the state after a round and the remaining ks to FILE, a finished run removes it" << std::endl
+              << "  --checkpoint-interval S  Minimum number of seconds between two checkpoints, 0 for every round (default: 60)" << std::endl
+              << "  --resume            Continue from the checkpoint FILE with the ks of the killed run, for those that were left" << std::endl
+              << "  --time-budget S     Finish within S seconds, with approximate partitions for the ks not reached in time" << std::endl
+              << "  --engine ENGINE     exact, or multilevel to partition a coarsened hypergraph and refine (default: exact)" << std::endl
+              << "  --coarsen-to N      Coarsen until at most N sites differ in their repeat classes (default: 1000)" << std::endl
+              << "  --refine            Move sites between blocks to lower the maximum number of repeat classes per block" << std::endl
+              << "  --refine-time S     Refine each partitioning for at most S seconds (default: no limit)" << std::endl
+              << "  --locality-reordering  Reorder the elements of E by similarity before each round" << std::endl;
 }
 
-int main(int argc, char **argv) {
+static int run(int argc, char **argv) {
+    // Every rank runs main, all of them parse the same arguments and read the same file
+    initDistributed(argc, argv);
+    std::atexit(finalizeDistributed);
+
     std::string filepath;
     uint32_t partitionNumber = 0;
     std::set<size_t> kSet;
+    PartitionOptions options;
+    // The time budget covers the whole run, including reading the file
+    options.timeBudgetStart = std::chrono::steady_clock::now();
+    std::string profilePath;
+    std::string hierarchyPath;
+    DDFWriter::Target outputTarget = DDFWriter::Target::STDOUT;
+    std::string outputPath;
+    std::string cacheDirectory;
+    bool resume = false;
+    const char *program = argv[0];
+
+    // Parse options
+    const option longOptions[] = {
+            { "memory-budget", required_argument, nullptr, 'm' },
+            { "spill-dir", required_argument, nullptr, 's' },
+            { "threads", required_argument, nullptr, 't' },
+            { "numa", required_argument, nullptr, 'n' },
+            { "cpus", required_argument, nullptr, 'u' },
+            { "profile", required_argument, nullptr, 'p' },
+            { "perf-counters", no_argument, nullptr, 'c' },
+            { "telemetry", required_argument, nullptr, 'l' },
+            { "hierarchy", required_argument, nullptr, 'h' },
+            { "output-dir", required_argument, nullptr, 'o' },
+            { "output-container", required_argument, nullptr, 'x' },
+            { "cache", required_argument, nullptr, 'a' },
+            { "checkpoint", required_argument, nullptr, 'k' },
+            { "checkpoint-interval", required_argument, nullptr, 'i' },
+            { "resume", no_argument, nullptr, 'r' },
+            { "time-budget", required_argument, nullptr, 'b' },
+            { "engine", required_argument, nullptr, 'e' },
+            { "coarsen-to", required_argument, nullptr, 'g' },
+            { "refine", no_argument, nullptr, 'f' },
+            { "refine-time", required_argument, nullptr, 'j' },
+            { "locality-reordering", no_argument, nullptr, 'y' },
+            { nullptr, 0, nullptr, 0 }
+    };
+    int opt;
+    while ((opt = getopt_long(argc, argv, "", longOptions, nullptr)) != -1) {
+        switch (opt) {
+            case 'm':
+                if (!parseNumber(optarg, options.memoryBudget) || options.memoryBudget > SIZE_MAX / 1024 / 1024) {
+                    printUsage(program);
+                    return 1;
+                }
+                options.memoryBudget *= 1024 * 1024;
+                break;
+            case 's':
+                options.spillDirectory = optarg;
+                break;
+            case 't':
+                if (!parseNumber(optarg, options.numThreads)) {
+                    printUsage(program);
+                    return 1;
+                }
+                break;
+            case 'n':
+                if (!parseNumaMode(optarg, options.numaMode)) {
+                    std::cerr << "Unknown or unsupported NUMA mode " << optarg << std::endl;
+                    return 1;
+                }
+                break;
+            case 'u':
+                if (!parseNumbers(optarg, options.cpus)) {
+                    printUsage(program);
+                    return 1;
+                }
+                break;
+            case 'p':
+                profilePath = optarg;
+                break;
+            case 'c':
+                if (!PerfCounters::enable()) {
+                    std::cerr << "Hardware performance counters are not available, only measuring time" << std::endl;
+                }
+                break;
+            case 'l':
+                options.telemetryPath = optarg;
+                break;
+            case 'h':
+                hierarchyPath = optarg;
+                break;
+            case 'o':
+                outputTarget = DDFWriter::Target::DIRECTORY;
+                outputPath = optarg;
+                break;
+            case 'x':
+                outputTarget = DDFWriter::Target::CONTAINER;
+                outputPath = optarg;
+                break;
+            case 'a':
+                cacheDirectory = optarg;
+                break;
+            case 'k':
+                options.checkpointPath = optarg;
+                break;
+            case 'i':
+                if (!parseNumber(optarg, options.checkpointInterval)) {
+                    printUsage(program);
+                    return 1;
+                }
+                break;
+            case 'r':
+                resume = true;
+                break;
+            case 'b':
+                if (!parseNumber(optarg, options.timeBudget)) {
+                    printUsage(program);
+                    return 1;
+                }
+                break;
+            case 'e':
+                if (!parseEngine(optarg, options.engine)) {
+                    std::cerr << "Unknown engine " << optarg << std::endl;
+                    return 1;
+                }
+                break;
+            case 'g':
+                if (!parseNumber(optarg, options.coarseningTarget)) {
+                    printUsage(program);
+                    return 1;
+                }
+                break;
+            case 'f':
+                options.refinement = true;
+                break;
+            case 'j':
+                if (!parseNumber(optarg, options.refinementTime)) {
+                    printUsage(program);
+                    return 1;
+                }
+                break;
+            case 'y':
+                options.localityReordering = true;
+                break;
+            default:
+                printUsage(program);
+                return 1;
+        }
+    }
+    argc -= optind - 1;
+    argv += optind - 1;
 
     // Parse arguments
     if (argc == 3 || argc == 4) {
@@ -74,19 +230,132 @@ int main(int argc, char **argv) {
             pstr >> partitionNumber;
         }
     } else {
-        std::cout << "Usage: " << argv[0] << " partition_file k1[,k2[,k3...]] [partition_number]" << std::endl;
+        printUsage(program);
+        return 1;
+    }
+
+    // The state of the rounds belongs to the hypergraph they ran on, which the multilevel engine does not keep
+    if (options.engine == Engine::MULTILEVEL && (!hierarchyPath.empty() || !cacheDirectory.empty() || !options.checkpointPath.empty())) {
+        std::cerr << "The multilevel engine does not support --hierarchy, --cache and --checkpoint" << std::endl;
         return 1;
     }
 
     DEBUG_LOG(DEBUG_PROGRESS, "Reading graph from file...");
+    startTM("Parse");
     Hypergraph hypergraph = getHypergraphFromPartitionFile(filepath, partitionNumber);
+    endTM("Parse");
     DEBUG_LOG(DEBUG_PROGRESS, " Done\n");
 
     startTM("Runtime");
-    partition(hypergraph, kSet);
+    // The state starts from the checkpoint or the cached rounds if there are any
+    std::unique_ptr<ResultCache> cache;
+    PartitionState state;
+    if (!cacheDirectory.empty()) {
+        cache.reset(new ResultCache(cacheDirectory, options.localityReordering));
+    }
+    if (resume) {
+        // The checkpoint replaces the cache, both hold the state after some round
+        uint64_t checkpointKey = 0;
+        std::vector<size_t> remainingKs;
+        if (options.checkpointPath.empty()) {
+            std::cerr << "--resume needs the file of --checkpoint" << std::endl;
+            return 1;
+        }
+        if (!readCheckpoint(options.checkpointPath, checkpointKey, remainingKs, state)) {
+            std::cerr << "Could not read the checkpoint " << options.checkpointPath << std::endl;
+            return 1;
+        }
+        if (checkpointKey != ResultCache::getKey(hypergraph, options.localityReordering) || remainingKs.empty()) {
+            std::cerr << "The checkpoint " << options.checkpointPath << " belongs to another partition or build" << std::endl;
+            return 1;
+        }
+        // The ks have to be the ones of the killed run, the checkpoint holds those it had not written yet
+        for (size_t k : remainingKs) {
+            if (kSet.count(k) == 0) {
+                std::cerr << "The checkpoint " << options.checkpointPath << " has k = " << k << " left, which is not among the given ks" << std::endl;
+                return 1;
+            }
+        }
+        kSet = std::set<size_t>(remainingKs.begin(), remainingKs.end());
+        DEBUG_LOG(DEBUG_PROGRESS, "Resuming after round " + std::to_string(state.d) + "\n");
+    } else if (cache) {
+        if (cache->load(hypergraph, state)) {
+            DEBUG_LOG(DEBUG_PROGRESS, "Cached rounds: " + std::to_string(state.d) + "\n");
+        }
+    }
+    size_t cachedRounds = state.d;
+    PartitionState *statePointer = cache || resume ? &state : nullptr;
+
+    JudiciousPartitioner partitioner(options);
+    std::set<size_t> exactKs;
+    std::set<size_t> approximateKs;
+    if (!hierarchyPath.empty()) {
+        MergeHierarchy hierarchy = partitioner.partitionHierarchy(hypergraph, *kSet.begin(), statePointer);
+        if (getRank() == 0) {
+            std::ofstream hierarchyFile(hierarchyPath, std::ios::binary);
+            hierarchy.writeTo(hierarchyFile);
+            if (!hierarchyFile) {
+                std::cerr << "Could not write the hierarchy to " << hierarchyPath << std::endl;
+                return 1;
+            }
+        }
+    } else {
+        // All ranks find the same partitions, only the first one writes them
+        std::unique_ptr<DDFWriter> writer;
+        if (getRank() == 0) {
+            writer.reset(new DDFWriter(outputTarget, outputPath));
+        }
+        // Runs while the next round is computed
+        partitioner.partition(hypergraph, kSet, [&writer, &exactKs, &approximateKs](const SitePartitioning &partitioning) {
+            (partitioning.exact ? exactKs : approximateKs).insert(partitioning.k);
+            if (writer) {
+                startTM("printPartitions");
+                writer->write(partitioning.k, partitioning.getBlocks());
+                endTM("printPartitions");
+            }
+        }, statePointer);
+        if (writer && !writer->finish()) {
+            std::cerr << "Could not write the partitions to " << outputPath << std::endl;
+            return 1;
+        }
+    }
+    if (cache && getRank() == 0 && state.d > cachedRounds && !cache->store(hypergraph, state)) {
+        std::cerr << "Could not store the rounds in the cache " << cacheDirectory << std::endl;
+    }
     endTM("Runtime");
 
-    printAllTM();
+    if (getRank() == 0) {
+        // Before the summary, which has to end in the runtime
+        if (options.timeBudget > 0) {
+            std::cout << "Exact ks:";
+            for (size_t k : exactKs) {
+                std::cout << " " << k;
+            }
+            std::cout << std::endl << "Approximate ks:";
+            for (size_t k : approximateKs) {
+                std::cout << " " << k;
+            }
+            std::cout << std::endl;
+        }
+
+        printAllTM();
+
+        if (!profilePath.empty() && !Profiler::dump(profilePath)) {
+            std::cerr << "Could not write the profile to " << profilePath << std::endl;
+            return 1;
+        }
+    }
 
     return 0;
 }
+
+int main(int argc, char **argv) {
+    // The library reports files it cannot read or write with exceptions
+    try {
+        return run(argc, argv);
+    } catch (const std::exception &exception) {
+        std::cerr << exception.what() << std::endl;
+        abortDistributed(1);
+        return 1;
+    }
+}
@@ -8,8 +8,9 @@ import sys
 import itertools
 import argparse
 import math
+import resource
 
-runtime_pattern = re.compile("Runtime: (\d+)ms")
+runtime_pattern = re.compile("Runtime: (\d+)ms \\[peak (\d+)MB live")
 
 def generate_partitions_file(num_sites):
     file_name = "%s/supermatrix_subsample_single_partiton_%d.partitions" % (config.PARTITIONS_DIR, num_sites)
@@ -39,12 +40,17 @@ def weak_tests_generator(num_threads_list):
         num_sites = num_threads * config.WEAK_SCALING_SITES_PER_CORE
         yield ("weak", num_threads, num_sites, config.K)
 
-def measure_runtime(num_threads, num_sites, k, algorithm, thread_pinning):
-    my_env = os.environ.copy()
-    my_env["OMP_NUM_THREADS"] = str(num_threads)
+def limit_memory(memory_limit):
+    """ Limits the address space of the calling process to memory_limit MB, 0 for no limit """
+    if memory_limit > 0:
+        limit = memory_limit * 1024 * 1024
+        resource.setrlimit(resource.RLIMIT_AS, (limit, limit))
+
+def measure_runtime(num_threads, num_sites, k, algorithm, thread_pinning, memory_limit):
+    pinning_args = []
     if thread_pinning.enabled:
         pinning_str = ','.join(str(x) for x in thread_pinning.pinning(num_threads))
-        my_env["GOMP_CPU_AFFINITY"] = pinning_str
+        pinning_args = ["--cpus", pinning_str]
         sys.stderr.write("Pinning: " + pinning_str)
     else:
         sys.stderr.write("No pinning.")
@@ -55,15 +61,16 @@ def measure_runtime(num_threads, num_sites, k, algorithm, thread_pinning):
     sys.stderr.write(" Running with %d thread(s), %d sites and k=%d ..." % (num_threads, num_sites, k))
     sys.stderr.flush()
 
-    output = check_output(["%s/%s" % (config.JUDICIOUS_BIN, binary), file_name, str(k)], env=my_env)
+    output = check_output(["%s/%s" % (config.JUDICIOUS_BIN, binary), "--threads", str(num_threads)] + pinning_args + [file_name, str(k)],
+                          preexec_fn=lambda: limit_memory(memory_limit))
     sys.stderr.write(" done\n")
     sys.stderr.flush()
 
     runtime_line = output.split("\n".encode())[-2].decode()
-    runtime = int(re.match(runtime_pattern, runtime_line).group(1))
-    return runtime
+    match = re.match(runtime_pattern, runtime_line)
+    return (int(match.group(1)), int(match.group(2)))
 
-def run_tests(dry_run, num_threads_list, printer, scaling, algorithm, thread_pinning):
+def run_tests(dry_run, num_threads_list, printer, scaling, algorithm, thread_pinning, memory_limit):
     if scaling == "weak":
         test_params = weak_tests_generator(num_threads_list)
     elif scaling == "strong":
@@ -73,12 +80,12 @@ def run_tests(dry_run, num_threads_list, printer, scaling, algorithm, thread_pin
 
     for (scaling, num_threads, num_sites, k) in test_params:
         if dry_run:
-            runtime = 0
+            (runtime, peak_mb) = (0, 0)
         else:
             generate_partitions_file(num_sites)
             generate_repeats_file(num_sites)
-            runtime = measure_runtime(num_threads, num_sites, k, algorithm, thread_pinning)
-        printer.print_result(scaling, thread_pinning.mode, num_sites, k, num_threads, runtime)
+            (runtime, peak_mb) = measure_runtime(num_threads, num_sites, k, algorithm, thread_pinning, memory_limit)
+        printer.print_result(scaling, thread_pinning.mode, num_sites, k, num_threads, runtime, peak_mb)
 
 class CSVPrinter:
     """Prints the test results in csv format"""
@@ -93,11 +100,11 @@ class CSVPrinter:
             self.print_header()
 
     def print_header(self):
-        print("algorithm,pinning,scaling,machine,sites,k,threads,runtime")
+        print("algorithm,pinning,scaling,machine,sites,k,threads,runtime,peak_mb")
         sys.stdout.flush()
 
-    def print_result(self, scaling, pinning, num_sites, k, num_threads, runtime):
-        print("%s,%s,%s,%s,%d,%d,%d,%d" % (self._algorithm, pinning, scaling, self._machine_id, num_sites, k, num_threads, runtime))
+    def print_result(self, scaling, pinning, num_sites, k, num_threads, runtime, peak_mb):
+        print("%s,%s,%s,%s,%d,%d,%d,%d,%d" % (self._algorithm, pinning, scaling, self._machine_id, num_sites, k, num_threads, runtime, peak_mb))
         sys.stdout.flush()
 
 def parse_define(s):
@@ -176,11 +183,12 @@ if __name__ == "__main__":
     parser.add_argument("-m", "--machine-id", default="unknown", help="Machine id to print into the CSV field")
     parser.add_argument("-a", "--algorithm", default="unknown", help="Algorithm name to print into CSV field")
     parser.add_argument("-d", "--dry-run", action="store_true", help="Do not perform any measurements")
-    parser.add_argument("-t", "--nthreads", type=int, nargs="+", default=[1, 2, 4, 8], help="List of OMP_THREAD_NUM values to benchmark")
+    parser.add_argument("-t", "--nthreads", type=int, nargs="+", default=[1, 2, 4, 8], help="List of thread counts to benchmark, passed as --threads")
     parser.add_argument("-s", "--scaling", choices=["strong", "weak", "both"], default="both", help="Which kind of scaling test to perform")
     parser.add_argument("-P", "--param", action=SetParamAction, help="Change any values defined in config.py")
     parser.add_argument("-c", "--cpu-config", action=SetCPUConfigAction, help="Defines the CPU configuration as <nSockets>x<nCoresPerSocket>")
     parser.add_argument("-tp", "--thread_pinning", choices=["disabled", "balanced"], default="disabled", help="Choose thread pinning mode. disabled: no thread pinning. balanced: Use minimum number of sockets for given number of threads but balance out number of threads over per socket over the sockets.")
+    parser.add_argument("-M", "--memory-limit", type=int, default=0, help="Memory request of each run in MB, enforced as the limit of its address space. 0 for no limit")
     args = parser.parse_args()
 
     thread_pinning = None
@@ -192,5 +200,5 @@ if __name__ == "__main__":
     config.WEAK_SCALING_SITES_PER_CORE = config.MAX_SITES / max(args.nthreads)
 
     printer = CSVPrinter(args.machine_id, args.algorithm, args.print_header)
-    run_tests(args.dry_run, args.nthreads, printer, args.scaling, args.algorithm, thread_pinning)
+    run_tests(args.dry_run, args.nthreads, printer, args.scaling, args.algorithm, thread_pinning, args.memory_limit)
 
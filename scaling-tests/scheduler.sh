@@ -1,5 +1,10 @@
 #!/bin/bash
 
+# Memory request of each run in MB, enforced as the limit of its address space. Each run records the peak of its live
+# heap in the peak_mb column of the results. Keep this at the largest peak_mb of the machines plus headroom for the
+# thread stacks and the memory that is not counted, and lower it once the results of a full run are in.
+MEMORY_LIMIT_MB=16384
+
 tmux start-server
 tmux new-session -d -s scalingtests -n i10pc127
 tmux new-window -t scalingtests:1 -n i10pc128
@@ -7,11 +12,11 @@ tmux new-window -t scalingtests:2 -n 10pc129
 tmux new-window -t scalingtests:3 -n 10pc132
 tmux new-window -t scalingtests:4 -n 10pc134
 
-tmux send-keys -t scalingtests:0 "ssh i10pc127 'bash -l -s' < runSomeStuff.sh; ../src/notifier.py '\[i10pc127] Scaling tests done!' group" C-m
-tmux send-keys -t scalingtests:1 "ssh i10pc128 'bash -l -s' < runSomeStuff.sh; ../src/notifier.py '\[i10pc128] Scaling tests done!' group" C-m
-tmux send-keys -t scalingtests:2 "ssh i10pc129 'bash -l -s' < runSomeStuff.sh; ../src/notifier.py '\[i10pc129] Scaling tests done!' group" C-m
-tmux send-keys -t scalingtests:3 "ssh i10pc132 'bash -l -s' < runSomeStuff.sh; ../src/notifier.py '\[i10pc132] Scaling tests done!' group" C-m
-tmux send-keys -t scalingtests:4 "ssh i10pc134 'bash -l -s' < runSomeStuff.sh; ../src/notifier.py '\[i10pc134] Scaling tests done!' group" C-m
+tmux send-keys -t scalingtests:0 "ssh i10pc127 'MEMORY_LIMIT_MB=$MEMORY_LIMIT_MB bash -l -s' < runSomeStuff.sh; ../src/notifier.py '\[i10pc127] Scaling tests done!' group" C-m
+tmux send-keys -t scalingtests:1 "ssh i10pc128 'MEMORY_LIMIT_MB=$MEMORY_LIMIT_MB bash -l -s' < runSomeStuff.sh; ../src/notifier.py '\[i10pc128] Scaling tests done!' group" C-m
+tmux send-keys -t scalingtests:2 "ssh i10pc129 'MEMORY_LIMIT_MB=$MEMORY_LIMIT_MB bash -l -s' < runSomeStuff.sh; ../src/notifier.py '\[i10pc129] Scaling tests done!' group" C-m
+tmux send-keys -t scalingtests:3 "ssh i10pc132 'MEMORY_LIMIT_MB=$MEMORY_LIMIT_MB bash -l -s' < runSomeStuff.sh; ../src/notifier.py '\[i10pc132] Scaling tests done!' group" C-m
+tmux send-keys -t scalingtests:4 "ssh i10pc134 'MEMORY_LIMIT_MB=$MEMORY_LIMIT_MB bash -l -s' < runSomeStuff.sh; ../src/notifier.py '\[i10pc134] Scaling tests done!' group" C-m
 
 tmux select-window -t scalingtests:1
 tmux attach-session -t scalingtests
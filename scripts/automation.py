@@ -51,6 +51,7 @@ rccc_path = "../RepeatsCounter/RepeatsCounter/build/RepeatsCounter"
 naive_path = "./very_naive_split.py"
 rdda_path = "../RepeatsCounter/RDDA/build/rdda"
 judicious_path = "../JudiciousPartitioning/cmake-build-debug/JudiciousPartitioning"
+partition_splits_path = "../JudiciousPartitioning/cmake-build-debug/partitionSplits"
 hybrid_path = "./hybrid.py"
 
 block_numbers = [2, 4, 8, 12, 16, 24, 32, 48, 64, 96, 128, 160, 200, 256, 384, 512, 768, 1024, 1536, 2048, 3072, 4096, 8192 ]
@@ -3,7 +3,7 @@
 import subprocess
 import sys
 import os
-from automation import rdda_path
+from automation import rdda_path, partition_splits_path
 
 if len(sys.argv) != 4:
     print("Not enough arguments, expected './hybrid.py repeats_file num_blocks output_file\n")
@@ -16,12 +16,8 @@ output_file = str(sys.argv[3])
 p = subprocess.Popen([rdda_path, input_file, num_blocks, "/tmp/temp"], stdout=subprocess.PIPE, universal_newlines=True)
 p.communicate()
 
-# Run paritition_splits with temp.splits
-p = subprocess.Popen(["./partition_splits.py", input_file, "/tmp/temp.splits"], stdout=subprocess.PIPE, universal_newlines=True)
-stdout, _ = p.communicate()
+# Partition the split partitions for the ks of their shares only and write the distribution directly
+subprocess.run([partition_splits_path, "--output", output_file, input_file, "/tmp/temp.splits"], check=True)
 
 os.remove("/tmp/temp")
 os.remove("/tmp/temp.splits")
-
-with open(output_file, "w") as ofile:
-    print(stdout, file=ofile)
@@ -3,7 +3,6 @@
 
 import argparse
 import os
-import re
 import subprocess
 import sys
 from enum import Enum
@@ -163,23 +162,15 @@ def execute_judicious_partitioning(repeats_file : str, k, partition):
     folder_path = CACHE_FOLDER + "/" + folder_name
     if not os.path.isdir(folder_path):
         os.mkdir(folder_path)
+        # Writes one <k>.ddf per k into the cache folder
         judicious_partitioning_call = [
             JUDICIOUS_EXE,
+            "--output-dir", folder_path,
             repeats_file,
             ",".join(str(x) for x in range(2, JP_K_UP_TO + 1)),
             partition_number
         ]
-        p = subprocess.Popen(judicious_partitioning_call, universal_newlines=True, stdout=subprocess.PIPE)
-        stdout, _ = p.communicate()
-        current_file = None
-        for idx, line in enumerate(stdout.split("\n")):
-            if re.match("^\\d+$", line):
-                if current_file:
-                    current_file.close()
-                current_file = open(folder_path + "/" + line + ".ddf", "w")
-                current_file.write(line + "\n")
-            elif not line.startswith("Runtime"):
-                current_file.write(line + "\n")
+        subprocess.run(judicious_partitioning_call, stdout=subprocess.DEVNULL, check=True)
 
     # Check if file for needed k exists
     cachefile_path = folder_path + "/" + str(k) + ".ddf"